@@ -1,18 +1,43 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cctype>
 #include <ctime>
 #include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
 
 #include <libxml/HTMLparser.h>
 #include <libxml/HTMLtree.h>
 #include "httplib.h"
+#include "MizzouDining.h"
 
 #define D_MODE true // use the cached HTML file instead of live data
 #define D_TIME false // use a fake value for current time instead of the real time
 #define D_TIME_VAL "1:00 PM"
 
+#define DINING_HOST "https://dining.missouri.edu"
+#define CACHE_DIR "schedule_cache" // pages fetched from the server are kept here between runs
+#define CACHE_MAX_AGE 600 // seconds a cached page is used as-is before asking the server again
+#define D_STREAM true // parse the page as it downloads (SAX) instead of building a full DOM
+#define D_SERVE false // instead of printing once, keep running and serve the schedule over HTTP
+#define SERVE_PORT 8080
+#define REFRESH_INTERVAL 300 // seconds between background refreshes while serving
+
 // convert time str (relative to today's date) to an int for comparison
 // the int is simply the number of minutes since the start of the day
 int timeStrToInt(std::string timeStr) {
@@ -46,7 +71,11 @@ int timeStrToInt(std::string timeStr) {
     return min + hr24*60;
 }
 
-std::string intToTimeStr(int timeInt) {
+#define TIME_STR_MAX 16 // room formatTime needs for any int (real times are at most 8 chars, "12:00 PM")
+
+// writes timeInt like "6:30 AM" into buf (no terminator, no allocation)
+// returns the number of chars written
+size_t formatTime(int timeInt, char* buf) {
     int hr24 = timeInt / 60;
     int min = timeInt % 60;
 
@@ -61,14 +90,26 @@ std::string intToTimeStr(int timeInt) {
         hr12 = hr24 - 12; isAM = false;
     }
 
-    std::string pStr;
-    if (isAM) { pStr = " AM"; }
-    else { pStr = " PM"; }
-    std::string minStr;
-    if (min < 10) { minStr = "0" + std::to_string(min); }
-    else { minStr = std::to_string(min); }
-    std::string hr12Str = std::to_string(hr12);
-    return hr12Str + ":" + minStr + pStr;
+    // hour digits, most significant first
+    char digits[12];
+    int nDigits = 0;
+    unsigned int h = (unsigned int)hr12;
+    do { digits[nDigits++] = (char)('0' + h % 10); h /= 10; } while (h > 0);
+
+    size_t n = 0;
+    while (nDigits > 0) { buf[n++] = digits[--nDigits]; }
+    buf[n++] = ':';
+    buf[n++] = (char)('0' + min / 10);
+    buf[n++] = (char)('0' + min % 10);
+    buf[n++] = ' ';
+    buf[n++] = isAM ? 'A' : 'P';
+    buf[n++] = 'M';
+    return n;
+}
+
+std::string intToTimeStr(int timeInt) {
+    char buf[TIME_STR_MAX];
+    return std::string(buf, formatTime(timeInt, buf));
 }
 
 struct TimeBlock {
@@ -82,9 +123,35 @@ struct TimeBlock {
     }
 };
 
+// a single reading of the clock, taken once and passed to everything evaluated in the same batch,
+// so locations parsed a moment apart can't disagree across a minute boundary
+struct ClockSnapshot {
+    int nowInt; // minutes since the start of the day
+
+    // reads the real clock (or D_TIME_VAL when D_TIME is set)
+    static ClockSnapshot now() {
+        if (!D_TIME) {
+            time_t t = time(NULL);
+            struct tm tmVal;
+            localtime_r(&t, &tmVal); // unlike localtime, safe to call from any thread
+            return at(tmVal.tm_min + tmVal.tm_hour*60);
+        }
+        else {
+            return at(timeStrToInt(D_TIME_VAL));
+        }
+    }
+
+    // a fixed time, e.g. ClockSnapshot::at(timeStrToInt("1:00 PM")) in tests
+    static ClockSnapshot at(int nowInt) {
+        ClockSnapshot clock;
+        clock.nowInt = nowInt;
+        return clock;
+    }
+};
+
 // Define the HardCodedLocation struct
 struct HardCodedLocation {
-    std::string name;
+    const char* name;
     double latitude;
     double longitude;
 };
@@ -94,218 +161,369 @@ struct Location {
     // note that 0.0 is a valid value for these if a corresponding HardCodedLocation wasn't found
     double latitude;
     double longitude;
-    std::string strHours;
     bool favorite;
     bool open;
     std::vector<TimeBlock> hours;
 
     Location(const std::string& _name, double _latitude, double _longitude, const std::vector<TimeBlock>& _hours)
-        : name(_name), latitude(_latitude), longitude(_longitude), hours(_hours), favorite(false), open(false) {
-        // create a nice string representation of the data
-        strHours = "";
-        for (TimeBlock& tb : hours) {
-            strHours += tb.label + ": " + intToTimeStr(tb.start) + " to " + intToTimeStr(tb.end) + "\n";
-        }
+        : name(_name), latitude(_latitude), longitude(_longitude), favorite(false), open(false), hours(_hours) {
     }
 
-    // check if this location is open by comparing the current time with the scheduled hours
-    // (it only makes sense to call this if the hours are for the current date)
-    void checkIfOpen() {
-        int nowInt;
-        if (!D_TIME) {
-            time_t t = time(NULL);
-            struct tm* tmPtr = localtime(&t);
-            nowInt = tmPtr->tm_min + tmPtr->tm_hour*60;
-        }
-        else {
-            nowInt = timeStrToInt(D_TIME_VAL);
+    // writes a nice string representation of the hours into buf, like:
+    // "Lunch: 11:00 AM to 2:00 PM\nDinner: 4:30 PM to 8:00 PM\n"
+    // at most size - 1 chars are written, plus a terminator (like snprintf)
+    // returns the full length, so a return value >= size means buf was too small
+    size_t formatHours(char* buf, size_t size) const {
+        size_t n = 0;
+        char timeBuf[TIME_STR_MAX];
+        // copies whatever still fits, but always counts the full length
+        auto append = [&](const char* s, size_t len) {
+            if (n + 1 < size) {
+                size_t fits = std::min(len, size - 1 - n);
+                memcpy(buf + n, s, fits);
+            }
+            n += len;
+        };
+        for (const TimeBlock& tb : hours) {
+            append(tb.label.data(), tb.label.size());
+            append(": ", 2);
+            append(timeBuf, formatTime(tb.start, timeBuf));
+            append(" to ", 4);
+            append(timeBuf, formatTime(tb.end, timeBuf));
+            append("\n", 1);
         }
+        if (size > 0) { buf[std::min(n, size - 1)] = '\0'; }
+        return n;
+    }
+
+    // same as formatHours, for callers that want a std::string
+    std::string strHours() const {
+        char buf[256];
+        size_t n = formatHours(buf, sizeof(buf));
+        if (n < sizeof(buf)) { return std::string(buf, n); }
+        std::string s(n + 1, '\0');
+        formatHours(&s[0], s.size());
+        s.resize(n);
+        return s;
+    }
 
+    // check if this location is open by comparing the clock snapshot with the scheduled hours
+    // (it only makes sense to call this if the hours are for the same date as the snapshot)
+    void checkIfOpen(const ClockSnapshot& clock) {
+        open = false;
         for (TimeBlock& timeBlock : hours) {
-            if (timeBlock.start <= nowInt && nowInt <= timeBlock.end) {
+            if (timeBlock.start <= clock.nowInt && clock.nowInt <= timeBlock.end) {
                 open = true;
                 break;
             }
         }
     }
+
+    // same, against the current time (prefer evaluateOpenStatus when there's more than one)
+    void checkIfOpen() {
+        checkIfOpen(ClockSnapshot::now());
+    }
 };
 
+// sets the 'open' flag of every location against the same clock snapshot
+void evaluateOpenStatus(std::vector<Location>& locations, const ClockSnapshot& clock) {
+    for (Location& l : locations) {
+        l.checkIfOpen(clock);
+    }
+}
+
+// whitespace as the hours text uses it (same set as std::isspace in the C locale)
+bool isHrsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// parses a "6:30" token followed by an "AM"/"PM" token into minutes since the start of the day
+// returns 0 on fail, 1 on success
+int parseClockTokens(const char* timeTok, const char* timeEnd, const char* pTok, const char* pEnd, int* out) {
+    int hr12 = 0;
+    const char* c = timeTok;
+    while (c < timeEnd && std::isdigit((unsigned char)*c)) { hr12 = hr12*10 + (*c - '0'); c++; }
+    if (c == timeTok || c == timeEnd || *c != ':') { return 0; }
+    c++;
+    int min = 0;
+    const char* minBegin = c;
+    while (c < timeEnd && std::isdigit((unsigned char)*c)) { min = min*10 + (*c - '0'); c++; }
+    if (c == minBegin || pEnd - pTok < 2) { return 0; }
+
+    bool isAM;
+    if (pTok[0] == 'A' || pTok[0] == 'a') { isAM = true; }
+    else if (pTok[0] == 'P' || pTok[0] == 'p') { isAM = false; }
+    else { return 0; }
+
+    // same 12hr -> 24hr rules as timeStrToInt
+    int hr24;
+    if (hr12 == 12) { hr24 = isAM ? 0 : 12; }
+    else { hr24 = isAM ? hr12 : hr12 + 12; }
+    *out = min + hr24*60;
+    return 1;
+}
+
 // hrsStr may have multiple blocks and look like this:
 // "[spaces]Lunch[spaces]11:00 AM - 2:00 PM[spaces]Dinner[spaces]4:00 PM - 8:00 PM[spaces]"
 // OR just one:
 // "[spaces]11:00 AM - 2:00 PM[spaces]"
-std::vector<TimeBlock> parseHrsStr(std::string hrsStr) {
-    std::vector<TimeBlock> timeBlocks;
-
-    // trim hrsStr
-    int beginIdx = 0;
-    while (std::isspace(hrsStr[beginIdx])) { beginIdx++; }
-    int endIdx = hrsStr.size() - 4;
-    while (std::isspace(hrsStr[endIdx])) { endIdx--; }
-    hrsStr = hrsStr.substr(beginIdx, endIdx - beginIdx + 1);
-
-    // now it looks like: "Lunch[spaces]11:00 AM - 2:00 PM[spaces]Dinner[spaces]4:00 PM - 8:00 PM"
-    // or: "11:00 AM - 2:00 PM"
-    // std::cout << "`" << hrsStr << "`\n";
-
-    // HACK: should use std::string::find(str, pos) instead
-    // a view into a part of hrsStr, starting with the whole thing and shrinking from the left
-    std::string hrsStrView = hrsStr; int pos = 0;
-
-    // HACK: if the first char is a number, we have form #2
-    if (std::isdigit(hrsStr[0])) {
-        pos = hrsStrView.find(" ");
-        std::string startTimeStr = hrsStrView.substr(0, pos);
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        pos = hrsStrView.find(" ");
-        std::string startTimePStr = hrsStrView.substr(0, pos);
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        pos = hrsStrView.find(" ");
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        pos = hrsStrView.find(" ");
-        std::string endTimeStr = hrsStrView.substr(0, pos);
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        std::string endTimePStr = hrsStrView;
-        std::string startStr = startTimeStr + " " + startTimePStr;
-        std::string endStr = endTimeStr + " " + endTimePStr;
-        timeBlocks.push_back(TimeBlock{"Hours", timeStrToInt(startStr), timeStrToInt(endStr)});
-        return timeBlocks;
-    }
+//
+// the text is tokenized in place in a single pass (no substrings are made), and the blocks are
+// written into `out`, which is cleared first but keeps its capacity so it can be reused across rows
+// returns the number of blocks parsed (parsing stops early on malformed input)
+size_t parseHrsStr(const char* hrsStr, size_t len, std::vector<TimeBlock>& out) {
+    const char* p = hrsStr;
+    const char* end = hrsStr + len;
+    size_t count = 0;
+
+    // the label is every word seen since the last block, e.g. "Lunch" (or "Late Night")
+    const char* labelBegin = NULL;
+    const char* labelEnd = NULL;
+
+    // token cursor: [tok, tokEnd) is the current whitespace-delimited word
+    const char* tok;
+    const char* tokEnd;
+    #define NEXT_TOKEN() \
+        while (p < end && isHrsSpace(*p)) { p++; } \
+        tok = p; \
+        while (p < end && !isHrsSpace(*p)) { p++; } \
+        tokEnd = p;
 
     while (true) {
-        pos = hrsStrView.find(" "); // the first of many
-        std::string label = hrsStrView.substr(0, pos);
-        // std::cout << label << "\n";
+        NEXT_TOKEN();
+        if (tok == tokEnd) { break; }
 
-        while (std::isspace(hrsStrView[pos])) { pos++; }
-        hrsStrView = hrsStrView.substr(pos, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
-
-        pos = hrsStrView.find(" ");
-        std::string startTimeStr = hrsStrView.substr(0, pos);
-        // std::cout << startTimeStr << "\n";
+        if (!std::isdigit((unsigned char)*tok)) {
+            if (labelBegin == NULL) { labelBegin = tok; }
+            labelEnd = tokEnd;
+            continue;
+        }
 
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
+        // "11:00 AM - 2:00 PM"
+        const char* startTok = tok; const char* startEnd = tokEnd;
+        NEXT_TOKEN();
+        const char* startPTok = tok; const char* startPEnd = tokEnd;
+        NEXT_TOKEN(); // the "-"
+        NEXT_TOKEN();
+        const char* endTok = tok; const char* endEnd = tokEnd;
+        NEXT_TOKEN();
+        const char* endPTok = tok; const char* endPEnd = tokEnd;
+
+        int start, finish;
+        if (!parseClockTokens(startTok, startEnd, startPTok, startPEnd, &start)
+            || !parseClockTokens(endTok, endEnd, endPTok, endPEnd, &finish)) {
+            break;
+        }
 
-        pos = hrsStrView.find(" ");
-        std::string startTimePStr = hrsStrView.substr(0, pos);
-        // std::cout << startTimePStr << "\n";
+        // reuse existing elements so their label strings keep their capacity
+        if (count < out.size()) {
+            TimeBlock& tb = out[count];
+            if (labelBegin == NULL) { tb.label.assign("Hours"); }
+            else { tb.label.assign(labelBegin, labelEnd - labelBegin); }
+            tb.start = start;
+            tb.end = finish;
+        }
+        else if (labelBegin == NULL) {
+            out.push_back(TimeBlock{"Hours", start, finish});
+        }
+        else {
+            out.push_back(TimeBlock{std::string(labelBegin, labelEnd - labelBegin), start, finish});
+        }
+        count++;
+        labelBegin = NULL;
+        labelEnd = NULL;
+    }
+    #undef NEXT_TOKEN
 
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
+    out.erase(out.begin() + count, out.end());
+    return count;
+}
 
-        pos = hrsStrView.find(" ");
+std::vector<TimeBlock> parseHrsStr(const std::string& hrsStr) {
+    std::vector<TimeBlock> timeBlocks;
+    parseHrsStr(hrsStr.data(), hrsStr.size(), timeBlocks);
+    return timeBlocks;
+}
 
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
+// NOTE: `xmlNode->children` might as well have been named `xmlNode->firstChild`, because that's what it is
+// it can be treated as a linked list of children using `xmlNode->children->next`
 
-        pos = hrsStrView.find(" ");
-        std::string endTimeStr = hrsStrView.substr(0, pos);
-        // std::cout << endTimeStr << "\n";
+// tag names interned in the document's dictionary, so elements can be matched by comparing
+// pointers instead of building a string from every node's name
+struct TableTagNames {
+    bool interned;
+    const xmlChar* tr;
+    const xmlChar* td;
+
+    TableTagNames(xmlDoc* doc) {
+        interned = doc->dict != NULL;
+        tr = lookup(doc, "tr");
+        td = lookup(doc, "td");
+    }
 
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
+    const xmlChar* lookup(xmlDoc* doc, const char* name) {
+        return interned ? xmlDictLookup(doc->dict, BAD_CAST name, -1) : BAD_CAST name;
+    }
 
-        std::string endTimePStr;
-        pos = hrsStrView.find(" ");
-        bool done = false;
-        if (pos == -1) {
-            endTimePStr = hrsStrView;
-            done = true;
-        }
+    bool is(const xmlNode* node, const xmlChar* name) const {
+        if (node->type != XML_ELEMENT_NODE) { return false; }
+        return interned ? node->name == name : xmlStrEqual(node->name, name);
+    }
+};
 
-        if (!done) { endTimePStr = hrsStrView.substr(0, pos); }
-        // std::cout << "endTimePStr: " << endTimePStr << "\n";
+// returns the node after `node` in document order without leaving the subtree of `root`,
+// or NULL when the subtree is exhausted (pass skipChildren to step over node's own subtree)
+// this walks using the parent pointers, so there's no recursion and nothing is allocated
+xmlNode* nextInSubtree(xmlNode* node, xmlNode* root, bool skipChildren) {
+    if (!skipChildren && node->type == XML_ELEMENT_NODE && node->children) {
+        return node->children;
+    }
+    while (node != root) {
+        if (node->next) { return node->next; }
+        node = node->parent;
+    }
+    return NULL;
+}
 
-        std::string startStr = startTimeStr + " " + startTimePStr;
-        std::string endStr = endTimeStr + " " + endTimePStr;
-        timeBlocks.push_back(TimeBlock{label, timeStrToInt(startStr), timeStrToInt(endStr)});
+struct ClientPoolStats {
+    size_t requests;          // leases handed out (one per page fetch)
+    size_t connections;       // new TCP (and TLS) connections made
+    size_t handshakesAvoided; // leases answered on a connection that was already open
+    size_t tlsResumed;        // reconnects that resumed a TLS session instead of a full handshake
+};
 
-        if (done) { break; }
+// process-wide pool of keep-alive clients keyed by host, so repeated and batched fetches reuse
+// warm connections (and TLS sessions) instead of connecting and handshaking every time
+struct ClientPool {
+    std::mutex mutex;
+    std::map<std::string, std::vector<httplib::Client*>> idle;
+    ClientPoolStats stats;
+    size_t maxIdlePerHost;
 
-        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
-        pos = 0;
+    ClientPool() : maxIdlePerHost(8) {
+        memset(&stats, 0, sizeof(stats));
+    }
 
-        // there's a lot of spaces now so we skip over them
-        while (std::isspace(hrsStrView[pos])) { pos++; }
-        hrsStrView = hrsStrView.substr(pos, hrsStrView.size() - 1);
-        // std::cout << "`" << hrsStrView << "`\n";
+    ~ClientPool() {
+        for (auto& entry : idle) {
+            for (httplib::Client* cli : entry.second) { delete cli; }
+        }
     }
 
-    return timeBlocks;
-}
+    ClientPool(const ClientPool&) = delete;
+    ClientPool& operator=(const ClientPool&) = delete;
 
-// NOTE: `xmlNode->children` might as well have been named `xmlNode->firstChild`, because that's what it is
-// it can be treated as a linked list of children using `xmlNode->children->next`
+    // returns an idle client for host, or a new one if there isn't one
+    httplib::Client* acquire(const std::string& host) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stats.requests++;
+            std::vector<httplib::Client*>& clients = idle[host];
+            if (!clients.empty()) {
+                httplib::Client* cli = clients.back();
+                clients.pop_back();
+                return cli;
+            }
+        }
+        httplib::Client* cli = new httplib::Client(host);
+        cli->set_keep_alive(true);
+        cli->enable_server_certificate_verification(false);
+        return cli;
+    }
 
-// searches for a child (or sibling) element of node with the provided string "name"
-void _getElementsByTagName(xmlNode* node, std::string name, std::vector<xmlNode*>& results) {
-    xmlNode* currNode = NULL;
-    for (currNode = node; currNode; currNode = currNode->next) {
-        if (currNode->type == XML_ELEMENT_NODE && std::string((const char*)currNode->name) == name) {
-            results.push_back(currNode);
+    // returns cli to the pool; `connectionsBefore`/`resumedBefore` are its counters from acquire time,
+    // and `answered` says whether its request got a response (a failed connect opens nothing, so
+    // it mustn't count as a handshake avoided)
+    void release(const std::string& host, httplib::Client* cli, size_t connectionsBefore, size_t resumedBefore,
+                 bool answered) {
+        size_t connections = cli->connection_count() - connectionsBefore;
+        size_t resumed = cli->tls_session_resumed_count() - resumedBefore;
+
+        std::lock_guard<std::mutex> guard(mutex);
+        stats.connections += connections;
+        stats.tlsResumed += resumed;
+        if (answered && connections == 0) { stats.handshakesAvoided++; }
+
+        std::vector<httplib::Client*>& clients = idle[host];
+        if (clients.size() < maxIdlePerHost) {
+            clients.push_back(cli);
+        }
+        else {
+            delete cli;
         }
-        _getElementsByTagName(currNode->children, name, results);
     }
+};
+
+ClientPool& clientPool() {
+    static ClientPool pool;
+    return pool;
 }
 
-// searches for a child element of node with the provided string "name"
-// results vector must be allocated by the caller
-void getElementsByTagName(xmlNode* node, std::string name, std::vector<xmlNode*>& results) {
-    _getElementsByTagName(node->children, name, results);
+ClientPoolStats clientPoolStats() {
+    ClientPool& pool = clientPool();
+    std::lock_guard<std::mutex> guard(pool.mutex);
+    return pool.stats;
 }
 
-std::vector<Location> GetScheduleData(const std::string& date, bool debugMode) {
-    std::vector<Location> locations;
+// borrows a client from the pool for as long as it's in scope
+struct PooledClient {
+    std::string host;
+    httplib::Client* cli;
+    size_t connectionsBefore;
+    size_t resumedBefore;
+    bool answered; // set by the borrower once its request got a response
+
+    PooledClient(const std::string& _host) : host(_host), answered(false) {
+        cli = clientPool().acquire(host);
+        connectionsBefore = cli->connection_count();
+        resumedBefore = cli->tls_session_resumed_count();
+    }
 
-    std::string html;
-    if (debugMode) {
-        // Use cached file for debugging
-        std::ifstream file("locations.html");
-        if (file.is_open()) {
-            html = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-        } else {
-            std::cerr << "Failed to open cached file." << std::endl;
-            return locations;
-        }
-    } else {
-        // Fetch data from Mizzou website
-        httplib::Client cli("https://dining.missouri.edu");
-        cli.enable_server_certificate_verification(false);
-
-        std::string path = "/locations/?hoursForDate=" + date;
-        auto res = cli.Get(path.c_str());
-        if (res && res->status == 200) {
-            html = res->body;
-        } else {
-            std::cerr << "Error fetching data from Mizzou website." << std::endl;
-            return locations;
-        }
+    ~PooledClient() {
+        clientPool().release(host, cli, connectionsBefore, resumedBefore, answered);
     }
 
+    PooledClient(const PooledClient&) = delete;
+    PooledClient& operator=(const PooledClient&) = delete;
+
+    httplib::Client* operator->() { return cli; }
+    httplib::Client& operator*() { return *cli; }
+};
+
+// parses a whole locations page into `locations` ('open' is left for evaluateOpenStatus)
+// returns 0 on fail, 1 on success
+int parseScheduleHtml(const std::string& html, std::vector<Location>& locations) {
     // Parse HTML using libxml2
     // TODO: error checking for malformed HTML document from server
     xmlDoc* doc = htmlReadMemory(html.c_str(), html.size() + 1, NULL, NULL, HTML_PARSE_NOERROR);
     if (doc == NULL) {
-        std::cerr << "Could not parse HTML." << std::endl;
-        return locations;
+        return 0;
     }
 
     xmlNode* root = xmlDocGetRootElement(doc);
-    std::vector<xmlNode*> results;
-    getElementsByTagName(root, "tr", results);
-    // std::cout << results.size() << " results:\n";
-    for (xmlNode* node : results) {
-        // std::cout << "found " << node->name << " with content: \n";
-        std::vector<xmlNode*> tdResults;
-        getElementsByTagName(node, "td", tdResults);
-        // there are always two result nodes, unless we're on a header row
-        if (tdResults.size() == 2) {
+    TableTagNames names(doc);
+    // reused for every row so parsing the hours doesn't allocate
+    std::vector<TimeBlock> timeBlocks;
+    // visit every row in a single pass over the document (the page has more than one table)
+    xmlNode* node = root;
+    while (node) {
+        if (!names.is(node, names.tr)) {
+            node = nextInSubtree(node, root, false);
+            continue;
+        }
+
+        // the cells are direct children of the row
+        xmlNode* tdResults[2];
+        int tdCount = 0;
+        for (xmlNode* cell = node->children; cell; cell = cell->next) {
+            if (names.is(cell, names.td)) {
+                if (tdCount < 2) { tdResults[tdCount] = cell; }
+                tdCount++;
+            }
+        }
+        // there are always two cells, unless we're on a header row
+        if (tdCount == 2) {
             std::string locName;
-            std::string hrsStr;
             for (int i = 0; i < 2; i++) {
                 xmlNode* tdElem = tdResults[i];
                 if (i == 0) {
@@ -320,167 +538,2110 @@ std::vector<Location> GetScheduleData(const std::string& date, bool debugMode) {
                 else {
                     // the second column is the hours
                     xmlChar* key = xmlNodeListGetString(doc, tdElem->children, 1);
-                    hrsStr = (const char*)key;
+                    parseHrsStr((const char*)key, xmlStrlen(key), timeBlocks);
                     xmlFree(key);
                 }
             }
 
-            std::vector<TimeBlock> timeBlocks = parseHrsStr(hrsStr);
-            Location l{locName, 0.0, 0.0, timeBlocks};
-            // initialize the 'open' flag based on the current time
-            l.checkIfOpen();
-            locations.push_back(l);
+            locations.push_back(Location{locName, 0.0, 0.0, timeBlocks});
         }
-        // std::cout << "\n\n";
+
+        // rows don't nest, so there's no need to look inside this one
+        node = nextInSubtree(node, root, true);
     }
 
     xmlFreeDoc(doc);
-    xmlCleanupParser();
 
-    return locations;
+    return 1;
 }
 
-// returns 0 on fail, 1 on success
-int searchByName(const std::vector<HardCodedLocation>& hcls, std::string name, HardCodedLocation* out) {
-    for (auto& hcl : hcls) {
-        if (hcl.name == name) {
-            *out = hcl;
-            return 1;
-        }
+// 64-bit FNV-1a, used to name cached pages by their content
+// pass a previous result as `hash` to keep hashing where it left off
+uint64_t fnv1a(const char* data, size_t len, uint64_t hash = 14695981039346656037ULL) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
     }
-    return 0;
+    return hash;
 }
 
-// chop off n chars from end of s
-void rchop(std::string& s, int n) {
-    s.erase(s.size() - n, n);
+// hashes just the <tbody>...</tbody> ranges of a page, which is all the parser reads; the rest of
+// the page (scripts, nav, and the date in the table headers) changes from day to day even when
+// the hours don't. returns 0 if the page has no tables
+uint64_t hashScheduleTables(const std::string& html) {
+    uint64_t hash = 14695981039346656037ULL;
+    bool found = false;
+    size_t pos = 0;
+    while ((pos = html.find("<tbody", pos)) != std::string::npos) {
+        size_t end = html.find("</tbody>", pos);
+        if (end == std::string::npos) { end = html.size(); }
+        hash = fnv1a(html.data() + pos, end - pos, hash);
+        found = true;
+        pos = end;
+    }
+    return found ? hash : 0;
 }
 
-// THIS IS ONLY USED IN THE ANDROID VERSION (for passing C++ data to Java)
-//
-// output looks like:
-// [location]||||[location]||||...
-//
-// [location] looks like:
-// Baja Grill|||38.943203153879246|||-92.3267064269865|||[strHours]|||0|||1|||[timeBlocks]
-//
-// [timeBlocks] looks like:
-// Lunch|100|200||Dinner|300|400||Late-night|500|600||...
-std::string serializeLocations(const std::vector<Location>& locations) {
-    std::string out;
-    
-    // extract each Location
+// parsed pages by the hash of their tables, so dates with identical hours are only parsed once
+struct ParseCache {
+    std::mutex mutex;
+    std::map<uint64_t, std::shared_ptr<const std::vector<Location>>> byTables;
+    size_t hits;
+    size_t misses;
 
-    for (const Location& l : locations) {
-        std::string serializedLoc;
+    ParseCache() : hits(0), misses(0) {}
+};
 
-        // extract each Location parameter
+ParseCache& parseCache() {
+    static ParseCache cache;
+    return cache;
+}
 
-        // for (int i = 0; i < 7; i++) {
-        //     
-        //     serializedLoc += "|||";
-        // }
-        {
-            serializedLoc += l.name + "|||";
-            serializedLoc += std::to_string(l.latitude) + "|||";
-            serializedLoc += std::to_string(l.longitude) + "|||";
-            serializedLoc += l.strHours + "|||";
-            serializedLoc += std::to_string(l.favorite) + "|||";
-            serializedLoc += std::to_string(l.open) + "|||";
+// same as parseScheduleHtml, but returns the earlier result if a page with the same tables was
+// already parsed. the result is shared, so copy it before handing it out
+// returns NULL on fail
+std::shared_ptr<const std::vector<Location>> parseScheduleHtmlCached(const std::string& html) {
+    ParseCache& cache = parseCache();
+    uint64_t hash = hashScheduleTables(html);
+    if (hash != 0) {
+        std::lock_guard<std::mutex> guard(cache.mutex);
+        auto it = cache.byTables.find(hash);
+        if (it != cache.byTables.end()) {
+            cache.hits++;
+            return it->second;
+        }
+    }
 
-            // extract each TimeBlock
-            for (const TimeBlock& tb : l.hours) {
-                // extract each TimeBlock parameter
-                {
-                    serializedLoc += tb.label + "|";
-                    serializedLoc += std::to_string(tb.start) + "|";
-                    serializedLoc += std::to_string(tb.end);
-                    // at the end, don't add a final "|"
-                }
+    std::shared_ptr<std::vector<Location>> locations(new std::vector<Location>());
+    if (!parseScheduleHtml(html, *locations)) { return NULL; }
 
-                serializedLoc += "||";
-            }
-            rchop(serializedLoc, 2);
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.misses++;
+    if (hash != 0) { cache.byTables[hash] = locations; }
+    return locations;
+}
 
+// state for the streaming parser; only the <table> -> <tr> -> <td> structure is tracked,
+// everything else on the page is skipped as it goes by
+struct ScheduleSaxState {
+    std::vector<Location>* locations;
+    int tableDepth; // > 0 while inside a <table>
+    bool inRow;
+    int tdCount;    // number of <td>s seen so far in the current row
+    bool inTd;
+    int aDepth;     // > 0 while inside an <a> (the location name)
+    std::string locName;
+    std::string hrsStr;
+    std::vector<TimeBlock> timeBlocks; // reused for every row
+    ClockSnapshot clock; // every row's 'open' flag is evaluated against this
+};
+
+void scheduleSaxStartElement(void* ctx, const xmlChar* name, const xmlChar** attrs) {
+    (void)attrs;
+    ScheduleSaxState* s = (ScheduleSaxState*)ctx;
+    if (xmlStrEqual(name, BAD_CAST "table")) { s->tableDepth++; return; }
+    if (s->tableDepth == 0) { return; }
+
+    if (xmlStrEqual(name, BAD_CAST "tr")) {
+        s->inRow = true;
+        s->tdCount = 0;
+        s->locName.clear();
+        s->hrsStr.clear();
+    }
+    else if (s->inRow && xmlStrEqual(name, BAD_CAST "td")) {
+        s->inTd = true;
+        s->tdCount++;
+    }
+    else if (s->inTd && xmlStrEqual(name, BAD_CAST "a")) {
+        s->aDepth++;
+    }
+    else if (s->inTd && s->tdCount == 2 && xmlStrEqual(name, BAD_CAST "br")) {
+        // a <br /> separates a label from its times
+        s->hrsStr += ' ';
+    }
+}
+
+void scheduleSaxEndElement(void* ctx, const xmlChar* name) {
+    ScheduleSaxState* s = (ScheduleSaxState*)ctx;
+    if (s->tableDepth == 0) { return; }
+
+    if (xmlStrEqual(name, BAD_CAST "table")) {
+        s->tableDepth--;
+    }
+    else if (xmlStrEqual(name, BAD_CAST "td")) {
+        s->inTd = false;
+        s->aDepth = 0;
+    }
+    else if (s->aDepth > 0 && xmlStrEqual(name, BAD_CAST "a")) {
+        s->aDepth--;
+    }
+    else if (s->inRow && xmlStrEqual(name, BAD_CAST "tr")) {
+        s->inRow = false;
+        // there are always two cells, unless we're on a header row
+        if (s->tdCount == 2) {
+            parseHrsStr(s->hrsStr.data(), s->hrsStr.size(), s->timeBlocks);
+            Location l{s->locName, 0.0, 0.0, s->timeBlocks};
+            l.checkIfOpen(s->clock);
+            s->locations->push_back(l);
         }
-        // rchop(out, 3); // chop off trailing delim
+    }
+}
 
-        out += serializedLoc + "||||";
+void scheduleSaxCharacters(void* ctx, const xmlChar* ch, int len) {
+    ScheduleSaxState* s = (ScheduleSaxState*)ctx;
+    if (!s->inTd) { return; }
+    if (s->tdCount == 1 && s->aDepth > 0) {
+        s->locName.append((const char*)ch, len);
     }
-    rchop(out, 4); // chop off trailing delim
+    else if (s->tdCount == 2) {
+        s->hrsStr.append((const char*)ch, len);
+    }
+}
 
-    return out;
+// incrementally parses the locations page as chunks of it arrive, without building a DOM
+// Locations are appended to `locations` as soon as their row is closed
+struct ScheduleStreamParser {
+    ScheduleSaxState state;
+    xmlSAXHandler sax;
+    htmlParserCtxtPtr ctxt;
+
+    ScheduleStreamParser(std::vector<Location>& locations, const ClockSnapshot& clock) {
+        state.locations = &locations;
+        state.clock = clock;
+        state.tableDepth = 0;
+        state.inRow = false;
+        state.tdCount = 0;
+        state.inTd = false;
+        state.aDepth = 0;
+
+        memset(&sax, 0, sizeof(sax));
+        sax.startElement = scheduleSaxStartElement;
+        sax.endElement = scheduleSaxEndElement;
+        sax.characters = scheduleSaxCharacters;
+        sax.ignorableWhitespace = scheduleSaxCharacters;
+
+        ctxt = htmlCreatePushParserCtxt(&sax, &state, NULL, 0, NULL, XML_CHAR_ENCODING_NONE);
+        if (ctxt != NULL) {
+            htmlCtxtUseOptions(ctxt, HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING | HTML_PARSE_NONET);
+        }
+    }
+
+    ~ScheduleStreamParser() {
+        if (ctxt != NULL) {
+            htmlFreeParserCtxt(ctxt);
+        }
+    }
+
+    ScheduleStreamParser(const ScheduleStreamParser&) = delete;
+    ScheduleStreamParser& operator=(const ScheduleStreamParser&) = delete;
+
+    // returns false if the parser couldn't be created (the rest of the page can be dropped)
+    bool feed(const char* data, size_t len) {
+        if (ctxt == NULL) { return false; }
+        htmlParseChunk(ctxt, data, (int)len, 0);
+        return true;
+    }
+
+    // flushes anything still buffered; call once after the last chunk
+    bool finish() {
+        if (ctxt == NULL) { return false; }
+        htmlParseChunk(ctxt, NULL, 0, 1);
+        return true;
+    }
+};
+
+// writes all of data to fd, retrying short writes
+// returns 0 on fail, 1 on success
+int writeAll(int fd, const char* data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = write(fd, data + written, size - written);
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0) { return 0; }
+        written += n;
+    }
+    return 1;
 }
 
-int main() {
-    // Hardcode GPS coordinates for Mizzou dining locations
-    std::vector<HardCodedLocation> hardcodedLocations = {
-        {"Baja Grill", 38.943203153879246, -92.3267064269865},
-        {"Bookmark Café", 38.94444846006983, -92.32643268762787},
-        {"Do Mundo's", 38.94253788826768, -92.32686662995677},
-        {"Emporium Café", 38.94107459217775, -92.32304902570891},
-        {"infusion", 38.9431030190833, -92.32550479820374},
-        {"Legacy Grill", 38.93918339225931, -92.33160118208086},
-        {"Mort's", 38.9430322404151, -92.32697566673839},
-        {"Plaza 900 Dining", 38.94103367843988, -92.322668187628},
-        {"Potential Energy Café", 38.94623123277513, -92.32956715694311},
-        {"Pizza & MO", 38.94180412624759, -92.32309229325335},
-        {"Wings & MO", 38.94180412624759, -92.32309229325335},
-        {"Sabai", 38.94212344437987, -92.32450920297028},
-        {"Starbucks - Memorial Union", 38.94544954634613, -92.32511273180572},
-        {"Starbucks - Southwest", 38.93916939101163, -92.33207097791104},
-        {"Subway - Southwest", 38.93916939101163, -92.33207097791104},
-        {"Sunshine Sushi", 38.9425837776428, -92.32676330297024},
-        {"The MARK on 5th Street", 38.94533889956199, -92.33233735694316},
-        {"Truffles", 38.93916939101163, -92.33206024907547},
-        {"Wheatstone Bistro", 38.94548111216589, -92.3250477606413},
-        {"Panda Express", 38.94278414251326, -92.32674715879237},
-        {"The Restaurants at Southwest", 38.93912766582345, -92.33210316441776},
-        {"Mizzou Market Central", 38.94254132210812, -92.32717908392979},
-        {"Mizzou Market - Southwest", 38.93921968905726, -92.33280040112133},
-    };
-    std::string date = "2023-12-04";  // Replace with the desired date
+// writes data to path via a uniquely named temporary file in the same directory and a rename,
+// so readers never see a half-written file and concurrent writers can't clobber each other's
+// temporary file (the last rename wins)
+// returns 0 on fail, 1 on success
+int writeFileAtomically(const std::string& path, const char* data, size_t size) {
+    std::string tmpPath = path + ".XXXXXX";
+    int fd = mkstemp(&tmpPath[0]);
+    if (fd < 0) { return 0; }
+    // mkstemp creates the file 0600, but these are meant to be readable like any other
+    bool ok = writeAll(fd, data, size) && fchmod(fd, 0644) == 0;
+    if (close(fd) != 0) { ok = false; }
+    if (ok && rename(tmpPath.c_str(), path.c_str()) == 0) { return 1; }
+    unlink(tmpPath.c_str());
+    return 0;
+}
 
-    std::vector<Location> locations = GetScheduleData(date, D_MODE);
+// a page written to disk as it downloads, so it never has to be held whole: the chunks go to a
+// uniquely named temporary file in `dir` and are hashed as they go, and ScheduleCache::storeFetched
+// renames the file into place once the hash is known (like writeFileAtomically, in pieces)
+struct PageWriter {
+    std::string tmpPath;
+    int fd;
+    uint64_t hash;
+    bool ok; // every chunk so far was written
+
+    PageWriter(const std::string& dir) : tmpPath(dir + "/incoming.XXXXXX"), hash(fnv1a(NULL, 0)) {
+        fd = mkstemp(&tmpPath[0]);
+        ok = fd >= 0 && fchmod(fd, 0644) == 0;
+    }
 
-    // std::vector<TimeBlock> testTimeBlocks = parseHrsStr("10:00 AM - 3:00 PM");
-    // Location testLoc{"Test", 0.0, 0.0, testTimeBlocks};
-    // testLoc.checkIfOpen();
-    // locations.push_back(testLoc);
+    ~PageWriter() {
+        discard();
+    }
 
-    // Match locations with corresponding hardcoded coordinates
+    PageWriter(const PageWriter&) = delete;
+    PageWriter& operator=(const PageWriter&) = delete;
 
-    // for loop without `&` is similar to function in that it makes a copy of everything by default
-    // for (Location l : locations) {
-    for (Location& l : locations) {
-        HardCodedLocation hcl;
-        int ret = searchByName(hardcodedLocations, l.name, &hcl);
-        if (ret != 0) {
-            l.latitude = hcl.latitude;
-            l.longitude = hcl.longitude;
+    void append(const char* data, size_t len) {
+        hash = fnv1a(data, len, hash);
+        if (ok && !writeAll(fd, data, len)) { ok = false; }
+    }
+
+    // moves the page to `path`
+    // returns 0 on fail (the temporary file is removed), 1 on success
+    int commit(const std::string& path) {
+        if (fd < 0) { return 0; }
+        if (close(fd) != 0) { ok = false; }
+        fd = -1;
+        if (ok && rename(tmpPath.c_str(), path.c_str()) == 0) { return 1; }
+        unlink(tmpPath.c_str());
+        return 0;
+    }
+
+    // removes the temporary file, unless it was committed
+    void discard() {
+        if (fd < 0) { return; }
+        close(fd);
+        fd = -1;
+        unlink(tmpPath.c_str());
+    }
+};
+
+struct ScheduleCacheStats {
+    size_t hits;          // served from the cache without touching the network
+    size_t misses;        // fetched (and parsed) a new page
+    size_t revalidations; // the server answered 304, so the cached page was reused
+};
+
+// what we know about the cached page for one date
+struct CachedPageMeta {
+    std::string hash; // names the page file, so dates with identical pages share it
+    time_t fetched;
+    std::string etag;
+    std::string lastModified;
+};
+
+// on-disk cache of raw locations pages:
+//   CACHE_DIR/pages/<hash>.html  the page itself, named by the hash of its content
+//   CACHE_DIR/dates/<date>.meta  which page a date maps to, when it was fetched and its validators
+// pages used during this run are also kept in memory (by hash), so reusing one doesn't even
+// have to read it back from disk
+// a page is deleted once no date maps to it any more
+struct ScheduleCache {
+    std::string dir;
+    std::mutex mutex;
+    ScheduleCacheStats stats;
+    std::map<std::string, std::shared_ptr<const std::vector<Location>>> parsed;
+    std::mutex storeMutex; // held while pages are stored, dates repointed and pages evicted
+
+    ScheduleCache(const std::string& _dir) : dir(_dir) {
+        memset(&stats, 0, sizeof(stats));
+        mkdir(dir.c_str(), 0755);
+        mkdir((dir + "/pages").c_str(), 0755);
+        mkdir((dir + "/dates").c_str(), 0755);
+    }
+
+    std::string pagePath(const std::string& hash) { return dir + "/pages/" + hash + ".html"; }
+    std::string metaPath(const std::string& date) { return dir + "/dates/" + date + ".meta"; }
+
+    // returns 0 on fail, 1 on success
+    int writeFile(const std::string& path, const std::string& contents) {
+        return writeFileAtomically(path, contents.data(), contents.size());
+    }
+
+    // reads a meta file without checking that its page is there
+    // returns 0 on fail, 1 on success
+    int readMeta(const std::string& path, CachedPageMeta& meta) {
+        std::ifstream file(path);
+        if (!file.is_open()) { return 0; }
+        meta = CachedPageMeta{"", 0, "", ""};
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t pos = line.find(' ');
+            if (pos == std::string::npos) { continue; }
+            std::string key = line.substr(0, pos);
+            std::string value = line.substr(pos + 1);
+            if (key == "hash") { meta.hash = value; }
+            else if (key == "fetched") { meta.fetched = (time_t)atoll(value.c_str()); }
+            else if (key == "etag") { meta.etag = value; }
+            else if (key == "last-modified") { meta.lastModified = value; }
         }
+        return !meta.hash.empty();
     }
 
-    // for (size_t i = 0; i < std::min(locations.size(), hardcodedLocations.size()); ++i) {
-    //     locations[i].latitude = hardcodedLocations[i].latitude;
-    //     locations[i].longitude = hardcodedLocations[i].longitude;
-    // }
+    // returns 0 on fail (no meta, or its page is gone), 1 on success
+    int loadMeta(const std::string& date, CachedPageMeta& meta) {
+        if (!readMeta(metaPath(date), meta)) { return 0; }
+        struct stat st;
+        return stat(pagePath(meta.hash).c_str(), &st) == 0;
+    }
 
-    std::cout << "Successfully parsed\n";
-    std::cout << "List of locations:\n";
-    std::cout << "====================\n";
-    // Print information
-    if (locations.empty()) {
-        std::cout << "Locations vector is empty" << std::endl;
+    void storeMeta(const std::string& date, const CachedPageMeta& meta) {
+        std::string contents = "hash " + meta.hash + "\n";
+        contents += "fetched " + std::to_string((long long)meta.fetched) + "\n";
+        if (!meta.etag.empty()) { contents += "etag " + meta.etag + "\n"; }
+        if (!meta.lastModified.empty()) { contents += "last-modified " + meta.lastModified + "\n"; }
+        writeFile(metaPath(date), contents);
     }
-    else {
-        for (const auto& location : locations) {
-            std::cout << "Name: " << location.name << std::endl;
-            std::cout << location.strHours;
-            std::cout << "Open: " << (location.open ? "Yes" : "No") << std::endl;
-            std::cout << "GPS Coordinates: " << location.latitude << ", " << location.longitude << std::endl;
-            std::cout << "====================\n";
+
+    // stores a downloaded page (if a page with the same content isn't already stored) and
+    // returns its hash
+    std::string storePage(PageWriter& page) {
+        char hash[17];
+        snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)page.hash);
+        std::string path = pagePath(hash);
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) { page.commit(path); }
+        else { page.discard(); }
+        return hash;
+    }
+
+    // deletes the page with this hash if no date maps to it any more (call with storeMutex held)
+    void evictIfUnused(const std::string& hash) {
+        DIR* dates = opendir((dir + "/dates").c_str());
+        if (dates == NULL) { return; }
+        bool used = false;
+        while (struct dirent* entry = readdir(dates)) {
+            std::string name = entry->d_name;
+            if (name.size() <= 5 || name.compare(name.size() - 5, 5, ".meta") != 0) { continue; }
+            CachedPageMeta other;
+            if (readMeta(dir + "/dates/" + name, other) && other.hash == hash) {
+                used = true;
+                break;
+            }
+        }
+        closedir(dates);
+        if (used) { return; }
+
+        unlink(pagePath(hash).c_str());
+        std::lock_guard<std::mutex> guard(mutex);
+        parsed.erase(hash);
+    }
+
+    // stores a freshly fetched page and points `date` at it (filling in meta.hash); the page the
+    // date pointed at before (`previousHash`, empty if none) is evicted if nothing else uses it
+    void storeFetched(const std::string& date, PageWriter& page, const std::string& previousHash,
+                      CachedPageMeta& meta) {
+        std::lock_guard<std::mutex> guard(storeMutex);
+        meta.hash = storePage(page);
+        storeMeta(date, meta);
+        if (!previousHash.empty() && previousHash != meta.hash) { evictIfUnused(previousHash); }
+    }
+
+    // keeps locations parsed some other way (e.g. streamed) as the result for this hash
+    void remember(const std::string& hash, const std::vector<Location>& locations) {
+        std::shared_ptr<const std::vector<Location>> result(new std::vector<Location>(locations));
+        std::lock_guard<std::mutex> guard(mutex);
+        parsed[hash] = result;
+    }
+
+    // fills `locations` from the page with this hash, parsing it only if this run hasn't already
+    // returns 0 on fail, 1 on success
+    int locationsFor(const std::string& hash, const std::string* html, std::vector<Location>& locations) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            auto it = parsed.find(hash);
+            if (it != parsed.end()) {
+                locations = *it->second;
+                return 1;
+            }
+        }
+
+        std::string page;
+        if (html == NULL) {
+            std::ifstream file(pagePath(hash), std::ios::binary);
+            if (!file.is_open()) { return 0; }
+            page = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            html = &page;
         }
+        std::shared_ptr<const std::vector<Location>> result = parseScheduleHtmlCached(*html);
+        if (!result) { return 0; }
+        locations = *result;
+
+        std::lock_guard<std::mutex> guard(mutex);
+        parsed[hash] = result;
+        return 1;
+    }
+};
+
+ScheduleCache& scheduleCache() {
+    static ScheduleCache cache(CACHE_DIR);
+    return cache;
+}
+
+ScheduleCacheStats scheduleCacheStats() {
+    ScheduleCache& cache = scheduleCache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    return cache.stats;
+}
+
+// fetches the locations for `date` from `host` through `cache`, without evaluating 'open':
+// a page fetched less than CACHE_MAX_AGE seconds ago is used as is, otherwise the server is asked
+// with the cached page's validators so it can answer 304 instead of sending the page again, and
+// if it can't be reached at all a stale copy is used
+// with `stream` set, a new page is parsed (SAX) while it downloads instead of once it's complete
+// with `revalidate` set, the server is asked (conditionally) however recently the page was fetched;
+// the background refresher needs this, since it runs more often than CACHE_MAX_AGE
+// returns 0 on fail, 1 on success (on failure `locations` is left empty)
+int fetchThroughCache(ScheduleCache& cache, const std::string& host, const std::string& date, bool stream,
+                      std::vector<Location>& locations, bool revalidate = false) {
+    locations.clear();
+    CachedPageMeta meta;
+    bool haveCached = cache.loadMeta(date, meta);
+    time_t now = time(NULL);
+
+    // recently fetched, so don't even ask the server
+    if (haveCached && !revalidate && now - meta.fetched < CACHE_MAX_AGE && cache.locationsFor(meta.hash, NULL, locations)) {
+        std::lock_guard<std::mutex> guard(cache.mutex);
+        cache.stats.hits++;
+        return 1;
+    }
+
+    // ask the server, letting it answer 304 if our copy is still current
+    PooledClient cli(host);
+
+    httplib::Headers headers;
+    if (haveCached && !meta.etag.empty()) { headers.emplace("If-None-Match", meta.etag); }
+    if (haveCached && !meta.lastModified.empty()) { headers.emplace("If-Modified-Since", meta.lastModified); }
+
+    // a new page goes straight to its cache file as it arrives; only the DOM parse (without
+    // `stream`) needs it whole in memory as well
+    PageWriter page(cache.dir + "/pages");
+    std::string body;
+    std::vector<Location> streamed;
+    std::unique_ptr<ScheduleStreamParser> parser;
+    if (stream) { parser.reset(new ScheduleStreamParser(streamed, ClockSnapshot::now())); }
+
+    std::string path = "/locations/?hoursForDate=" + date;
+    auto res = cli->Get(path, headers,
+        [](const httplib::Response& response) { return response.status == 200 || response.status == 304; },
+        [&](const char* data, size_t len) {
+            page.append(data, len);
+            if (parser) { return parser->feed(data, len); }
+            body.append(data, len);
+            return true;
+        });
+    cli.answered = (bool)res;
+    if (res && res->status == 304 && haveCached) {
+        meta.fetched = now;
+        cache.storeMeta(date, meta);
+        if (cache.locationsFor(meta.hash, NULL, locations)) {
+            std::lock_guard<std::mutex> guard(cache.mutex);
+            cache.stats.revalidations++;
+            return 1;
+        }
+    }
+    else if (res && res->status == 200) {
+        std::string previousHash = haveCached ? meta.hash : "";
+        meta.fetched = now;
+        meta.etag = res->get_header_value("ETag");
+        meta.lastModified = res->get_header_value("Last-Modified");
+        cache.storeFetched(date, page, previousHash, meta);
+        {
+            std::lock_guard<std::mutex> guard(cache.mutex);
+            cache.stats.misses++;
+        }
+        if (parser) {
+            if (parser->finish()) {
+                locations.swap(streamed);
+                cache.remember(meta.hash, locations);
+                return 1;
+            }
+        }
+        else if (cache.locationsFor(meta.hash, &body, locations)) {
+            return 1;
+        }
+        std::cerr << "Could not parse HTML." << std::endl;
+        locations.clear();
+        return 0;
+    }
+
+    // the server couldn't be reached; a stale copy is better than nothing
+    if (haveCached && cache.locationsFor(meta.hash, NULL, locations)) {
+        std::cerr << "Error fetching data for " << date << ", using cached data." << std::endl;
+        return 1;
+    }
+    locations.clear();
+    return 0;
+}
+
+// fetches (or loads from a cache) and parses the locations for `date`, without evaluating 'open'
+// returns 0 on fail, 1 on success
+int fetchScheduleData(const std::string& date, bool debugMode, std::vector<Location>& locations) {
+    locations.clear();
+
+    if (debugMode) {
+        // Use cached file for debugging
+        std::ifstream file("locations.html");
+        if (!file.is_open()) {
+            std::cerr << "Failed to open cached file." << std::endl;
+            return 0;
+        }
+        std::string html = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        std::shared_ptr<const std::vector<Location>> result = parseScheduleHtmlCached(html);
+        if (!result) {
+            std::cerr << "Could not parse HTML." << std::endl;
+            return 0;
+        }
+        locations = *result;
+        return 1;
+    }
+
+    if (!fetchThroughCache(scheduleCache(), DINING_HOST, date, false, locations)) {
+        std::cerr << "Error fetching data from Mizzou website." << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+// same, for callers that treat an empty list as a failure
+std::vector<Location> fetchScheduleData(const std::string& date, bool debugMode) {
+    std::vector<Location> locations;
+    fetchScheduleData(date, debugMode, locations);
+    return locations;
+}
+
+// `clock` is what 'open' is evaluated against (the current time unless a test passes one in)
+std::vector<Location> GetScheduleData(const std::string& date, bool debugMode,
+                                      const ClockSnapshot& clock = ClockSnapshot::now()) {
+    std::vector<Location> locations = fetchScheduleData(date, debugMode);
+    evaluateOpenStatus(locations, clock);
+    return locations;
+}
+
+bool sameHours(const std::vector<TimeBlock>& a, const std::vector<TimeBlock>& b) {
+    if (a.size() != b.size()) { return false; }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].start != b[i].start || a[i].end != b[i].end || a[i].label != b[i].label) { return false; }
+    }
+    return true;
+}
+
+// one difference between two fetches of the schedule
+struct LocationChange {
+    enum Kind { ADDED, REMOVED, CHANGED };
+    Kind kind;
+    std::string name;
+    std::vector<TimeBlock> oldHours; // empty for ADDED
+    std::vector<TimeBlock> newHours; // empty for REMOVED
+};
+
+// compares two fetches of the schedule by location name and block list; unchanged locations
+// produce nothing, so the work downstream is proportional to what actually changed
+// (changes come out sorted by name)
+void diffLocations(const std::vector<Location>& before, const std::vector<Location>& after,
+                   std::vector<LocationChange>& changes) {
+    changes.clear();
+
+    // usual case: the page didn't change, so the names line up in the same order
+    if (before.size() == after.size()) {
+        bool same = true;
+        for (size_t i = 0; i < before.size() && same; i++) {
+            same = before[i].name == after[i].name && sameHours(before[i].hours, after[i].hours);
+        }
+        if (same) { return; }
+    }
+
+    auto byName = [](const Location* a, const Location* b) { return a->name < b->name; };
+    std::vector<const Location*> a, b;
+    for (const Location& l : before) { a.push_back(&l); }
+    for (const Location& l : after) { b.push_back(&l); }
+    std::sort(a.begin(), a.end(), byName);
+    std::sort(b.begin(), b.end(), byName);
+
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        LocationChange change;
+        if (j == b.size() || (i < a.size() && a[i]->name < b[j]->name)) {
+            change.kind = LocationChange::REMOVED;
+            change.name = a[i]->name;
+            change.oldHours = a[i]->hours;
+            i++;
+        }
+        else if (i == a.size() || b[j]->name < a[i]->name) {
+            change.kind = LocationChange::ADDED;
+            change.name = b[j]->name;
+            change.newHours = b[j]->hours;
+            j++;
+        }
+        else {
+            bool same = sameHours(a[i]->hours, b[j]->hours);
+            if (!same) {
+                change.kind = LocationChange::CHANGED;
+                change.name = a[i]->name;
+                change.oldHours = a[i]->hours;
+                change.newHours = b[j]->hours;
+            }
+            i++;
+            j++;
+            if (same) { continue; }
+        }
+        changes.push_back(change);
+    }
+}
+
+// a short line per change, like:
+// "+ Baja Grill [Lunch 11:00 AM-2:00 PM]"
+// "~ Plaza 900 [Breakfast 7:00 AM-10:00 AM] -> [Breakfast 7:30 AM-10:00 AM]"
+// "- Do Mundo's [Dinner 4:30 PM-8:00 PM]"
+std::string changeLog(const std::vector<LocationChange>& changes) {
+    char timeBuf[TIME_STR_MAX];
+    std::string log;
+    auto appendHours = [&](const std::vector<TimeBlock>& hours) {
+        log += '[';
+        for (size_t i = 0; i < hours.size(); i++) {
+            if (i > 0) { log += ", "; }
+            log += hours[i].label;
+            log += ' ';
+            log.append(timeBuf, formatTime(hours[i].start, timeBuf));
+            log += '-';
+            log.append(timeBuf, formatTime(hours[i].end, timeBuf));
+        }
+        log += ']';
+    };
+    for (const LocationChange& change : changes) {
+        switch (change.kind) {
+        case LocationChange::ADDED:
+            log += "+ " + change.name + " ";
+            appendHours(change.newHours);
+            break;
+        case LocationChange::REMOVED:
+            log += "- " + change.name + " ";
+            appendHours(change.oldHours);
+            break;
+        case LocationChange::CHANGED:
+            log += "~ " + change.name + " ";
+            appendHours(change.oldHours);
+            log += " -> ";
+            appendHours(change.newHours);
+            break;
+        }
+        log += '\n';
+    }
+    return log;
+}
+
+// diff mode for GetScheduleData: fetches the schedule again, fills `changes` with how it differs
+// from `snapshot` (the previous fetch, or empty the first time, in which case everything is ADDED),
+// then replaces `snapshot` with the new fetch
+// a failed fetch leaves both `snapshot` and `changes` alone, so a network hiccup doesn't look like
+// every location being removed (and then added back by the next successful fetch)
+// returns 0 on fail, 1 on success (with changes.size() changes, possibly none)
+int GetScheduleDataDiff(const std::string& date, bool debugMode, std::vector<Location>& snapshot,
+                        std::vector<LocationChange>& changes, const ClockSnapshot& clock = ClockSnapshot::now()) {
+    std::vector<Location> locations;
+    if (!fetchScheduleData(date, debugMode, locations)) { return 0; }
+    evaluateOpenStatus(locations, clock);
+    diffLocations(snapshot, locations, changes);
+    snapshot.swap(locations);
+    return 1;
+}
+
+// same as GetScheduleData, but parses the page while it's still downloading instead of
+// reading the whole thing into memory and building a DOM first
+std::vector<Location> StreamScheduleData(const std::string& date, bool debugMode,
+                                         const ClockSnapshot& clock = ClockSnapshot::now()) {
+    std::vector<Location> locations;
+
+    if (debugMode) {
+        // Use cached file for debugging, fed in chunks just like the network path
+        std::ifstream file("locations.html", std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open cached file." << std::endl;
+            return locations;
+        }
+        ScheduleStreamParser parser(locations, clock);
+        char buf[4096];
+        while (file.read(buf, sizeof(buf)) || file.gcount() > 0) {
+            if (!parser.feed(buf, file.gcount())) { break; }
+        }
+        if (!parser.finish()) {
+            std::cerr << "Could not parse HTML." << std::endl;
+        }
+    } else {
+        // Fetch data from Mizzou website (unless the cache has it)
+        if (!fetchThroughCache(scheduleCache(), DINING_HOST, date, true, locations)) {
+            std::cerr << "Error fetching data from Mizzou website." << std::endl;
+        }
+        evaluateOpenStatus(locations, clock);
+    }
+
+    return locations;
+}
+
+struct DaySchedule {
+    std::string date;
+    bool ok; // false if the page for this date couldn't be fetched
+    std::vector<Location> locations;
+};
+
+// expands the inclusive range [start, end] of "2023-12-04" style dates into every date in it
+// returns 0 on fail (malformed date or end before start), 1 on success
+int expandDateRange(const std::string& start, const std::string& end, std::vector<std::string>& dates) {
+    struct tm startTm, endTm;
+    const std::string* strs[2] = { &start, &end };
+    struct tm* tms[2] = { &startTm, &endTm };
+    for (int i = 0; i < 2; i++) {
+        int y, m, d;
+        if (sscanf(strs[i]->c_str(), "%d-%d-%d", &y, &m, &d) != 3) { return 0; }
+        memset(tms[i], 0, sizeof(struct tm));
+        tms[i]->tm_year = y - 1900;
+        tms[i]->tm_mon = m - 1;
+        tms[i]->tm_mday = d;
+        tms[i]->tm_hour = 12; // noon, so DST changes can't push us onto another day
+        tms[i]->tm_isdst = -1;
+    }
+
+    time_t endT = mktime(&endTm);
+    time_t curT = mktime(&startTm);
+    if (curT == -1 || endT == -1 || curT > endT) { return 0; }
+
+    char buf[16];
+    while (curT <= endT) {
+        strftime(buf, sizeof(buf), "%Y-%m-%d", &startTm);
+        dates.push_back(buf);
+        startTm.tm_mday++;
+        startTm.tm_hour = 12;
+        startTm.tm_isdst = -1;
+        curT = mktime(&startTm);
+    }
+    return 1;
+}
+
+// fetches every date in the inclusive range [start, end] using `concurrency` workers, so at most
+// that many requests are in flight at once (and the pool ends up with that many warm connections).
+// Pages go through `cache` like any other fetch, so dates fetched recently aren't downloaded
+// again, and are parsed through parseScheduleHtmlCached, so dates whose tables are identical
+// (most of them, usually) are only parsed once; parsing one date still overlaps the download of
+// the others. Results are returned in date order.
+// `host` (and `cache`) can be pointed at a local server for testing, and every date's 'open' flags
+// are evaluated against the same `clock`
+std::vector<DaySchedule> GetScheduleRange(const std::string& start, const std::string& end, int concurrency,
+                                          const std::string& host = DINING_HOST,
+                                          const ClockSnapshot& clock = ClockSnapshot::now(),
+                                          ScheduleCache& cache = scheduleCache()) {
+    std::vector<DaySchedule> days;
+    std::vector<std::string> dates;
+    if (!expandDateRange(start, end, dates)) {
+        std::cerr << "Invalid date range." << std::endl;
+        return days;
+    }
+
+    days.resize(dates.size());
+    for (size_t i = 0; i < dates.size(); i++) {
+        days[i].date = dates[i];
+        days[i].ok = false;
+    }
+
+    if (concurrency < 1) { concurrency = 1; }
+    if ((size_t)concurrency > days.size()) { concurrency = days.size(); }
+
+    // libxml2 must be initialized once on this thread before parsers are used from other threads
+    xmlInitParser();
+
+    // each worker takes the next unclaimed date and writes only that date's slot
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < concurrency; w++) {
+        workers.emplace_back([&]() {
+            size_t i;
+            while ((i = next++) < days.size()) {
+                // not streamed: the memo needs the whole page to hash its tables before parsing
+                days[i].ok = fetchThroughCache(cache, host, days[i].date, false, days[i].locations) != 0;
+                if (!days[i].ok) {
+                    std::cerr << "Error fetching data for " << days[i].date << "." << std::endl;
+                }
+                evaluateOpenStatus(days[i].locations, clock);
+            }
+        });
+    }
+    for (std::thread& t : workers) { t.join(); }
+
+    return days;
+}
+
+#define STORE_MAGIC 0x53535a4d // "MZSS" when read as little-endian bytes
+#define STORE_VERSION 1
+#define STORE_BYTE_ORDER 0x01020304 // reads back differently on a host with the other byte order
+
+// header of a schedule store file; every section starts at an 8 byte aligned offset, so once the
+// file is mapped each column can be used in place as a plain array
+struct ScheduleStoreHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t locationCount;
+    uint32_t labelCount;
+    uint32_t dateCount;
+    uint32_t blockCount;
+    uint32_t reserved;
+    uint64_t fileSize;
+
+    // location dictionary
+    uint64_t nameOffsetsOff; // u32[locationCount + 1] into nameBytes
+    uint64_t nameBytesOff;
+    uint64_t latitudesOff;   // f64[locationCount]
+    uint64_t longitudesOff;  // f64[locationCount]
+    // label dictionary
+    uint64_t labelOffsetsOff; // u32[labelCount + 1] into labelBytes
+    uint64_t labelBytesOff;
+    // per-date block table; the blocks for date d are dateBlocks[d] up to dateBlocks[d + 1]
+    uint64_t datesOff;      // u32[dateCount], 20231204 style, ascending
+    uint64_t dateBlocksOff; // u32[dateCount + 1]
+    // block columns
+    uint64_t blockLocationsOff; // u32[blockCount], location id
+    uint64_t blockLabelsOff;    // u32[blockCount], label id
+    uint64_t blockStartsOff;    // u16[blockCount], minutes since the start of the day
+    uint64_t blockEndsOff;      // u16[blockCount]
+};
+
+// "2023-12-04" -> 20231204 (0 if it isn't a date)
+uint32_t dateKey(const std::string& date) {
+    int y, m, d;
+    if (sscanf(date.c_str(), "%d-%d-%d", &y, &m, &d) != 3) { return 0; }
+    return (uint32_t)(y*10000 + m*100 + d);
+}
+
+// writes days (e.g. from GetScheduleRange) to a schedule store file at path, to be opened with
+// ScheduleStore; dates that failed to fetch are left out
+// returns 0 on fail, 1 on success
+int writeScheduleStore(const std::string& path, const std::vector<DaySchedule>& days) {
+    std::vector<const DaySchedule*> sorted;
+    for (const DaySchedule& day : days) {
+        if (day.ok && dateKey(day.date) != 0) { sorted.push_back(&day); }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const DaySchedule* a, const DaySchedule* b) {
+        return dateKey(a->date) < dateKey(b->date);
+    });
+
+    // build the dictionaries (ids are in order of first appearance)
+    std::map<std::string, uint32_t> locationIds, labelIds;
+    std::vector<const Location*> locations;
+    std::vector<const std::string*> labels;
+    size_t nameBytes = 0, labelBytes = 0, blockCount = 0;
+    for (const DaySchedule* day : sorted) {
+        for (const Location& l : day->locations) {
+            if (locationIds.insert(std::make_pair(l.name, (uint32_t)locations.size())).second) {
+                locations.push_back(&l);
+                nameBytes += l.name.size();
+            }
+            for (const TimeBlock& tb : l.hours) {
+                if (labelIds.insert(std::make_pair(tb.label, (uint32_t)labels.size())).second) {
+                    labels.push_back(&tb.label);
+                    labelBytes += tb.label.size();
+                }
+                blockCount++;
+            }
+        }
+    }
+
+    // lay out the sections
+    ScheduleStoreHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = STORE_MAGIC;
+    header.version = STORE_VERSION;
+    header.byteOrder = STORE_BYTE_ORDER;
+    header.locationCount = (uint32_t)locations.size();
+    header.labelCount = (uint32_t)labels.size();
+    header.dateCount = (uint32_t)sorted.size();
+    header.blockCount = (uint32_t)blockCount;
+
+    uint64_t off = sizeof(header);
+    auto section = [&off](uint64_t& field, size_t bytes) {
+        off = (off + 7) & ~(uint64_t)7;
+        field = off;
+        off += bytes;
+    };
+    section(header.nameOffsetsOff, 4 * (locations.size() + 1));
+    section(header.nameBytesOff, nameBytes);
+    section(header.latitudesOff, 8 * locations.size());
+    section(header.longitudesOff, 8 * locations.size());
+    section(header.labelOffsetsOff, 4 * (labels.size() + 1));
+    section(header.labelBytesOff, labelBytes);
+    section(header.datesOff, 4 * sorted.size());
+    section(header.dateBlocksOff, 4 * (sorted.size() + 1));
+    section(header.blockLocationsOff, 4 * blockCount);
+    section(header.blockLabelsOff, 4 * blockCount);
+    section(header.blockStartsOff, 2 * blockCount);
+    section(header.blockEndsOff, 2 * blockCount);
+    header.fileSize = off;
+
+    // fill in one buffer, then write it out in one go
+    std::string buf(header.fileSize, '\0');
+    char* base = &buf[0];
+    memcpy(base, &header, sizeof(header));
+
+    uint32_t* nameOffsets = (uint32_t*)(base + header.nameOffsetsOff);
+    double* latitudes = (double*)(base + header.latitudesOff);
+    double* longitudes = (double*)(base + header.longitudesOff);
+    uint32_t pos = 0;
+    for (size_t i = 0; i < locations.size(); i++) {
+        nameOffsets[i] = pos;
+        memcpy(base + header.nameBytesOff + pos, locations[i]->name.data(), locations[i]->name.size());
+        pos += locations[i]->name.size();
+        latitudes[i] = locations[i]->latitude;
+        longitudes[i] = locations[i]->longitude;
+    }
+    nameOffsets[locations.size()] = pos;
+
+    uint32_t* labelOffsets = (uint32_t*)(base + header.labelOffsetsOff);
+    pos = 0;
+    for (size_t i = 0; i < labels.size(); i++) {
+        labelOffsets[i] = pos;
+        memcpy(base + header.labelBytesOff + pos, labels[i]->data(), labels[i]->size());
+        pos += labels[i]->size();
+    }
+    labelOffsets[labels.size()] = pos;
+
+    uint32_t* dates = (uint32_t*)(base + header.datesOff);
+    uint32_t* dateBlocks = (uint32_t*)(base + header.dateBlocksOff);
+    uint32_t* blockLocations = (uint32_t*)(base + header.blockLocationsOff);
+    uint32_t* blockLabels = (uint32_t*)(base + header.blockLabelsOff);
+    uint16_t* blockStarts = (uint16_t*)(base + header.blockStartsOff);
+    uint16_t* blockEnds = (uint16_t*)(base + header.blockEndsOff);
+    uint32_t b = 0;
+    for (size_t d = 0; d < sorted.size(); d++) {
+        dates[d] = dateKey(sorted[d]->date);
+        dateBlocks[d] = b;
+        for (const Location& l : sorted[d]->locations) {
+            uint32_t locationId = locationIds[l.name];
+            for (const TimeBlock& tb : l.hours) {
+                blockLocations[b] = locationId;
+                blockLabels[b] = labelIds[tb.label];
+                blockStarts[b] = (uint16_t)tb.start;
+                blockEnds[b] = (uint16_t)tb.end;
+                b++;
+            }
+        }
+    }
+    dateBlocks[sorted.size()] = b;
+
+    return writeFileAtomically(path, buf.data(), buf.size());
+}
+
+// a schedule store file (see writeScheduleStore) mapped into memory; the columns are read
+// straight out of the mapping, so opening it doesn't deserialize anything
+struct ScheduleStore {
+    httplib::detail::mmap map;
+    const ScheduleStoreHeader* header;
+
+    const uint32_t* nameOffsets;
+    const char* nameBytes;
+    const double* latitudes;
+    const double* longitudes;
+    const uint32_t* labelOffsets;
+    const char* labelBytes;
+    const uint32_t* dates;
+    const uint32_t* dateBlocks;
+    const uint32_t* blockLocations;
+    const uint32_t* blockLabels;
+    const uint16_t* blockStarts;
+    const uint16_t* blockEnds;
+
+    ScheduleStore() : map(""), header(NULL) {}
+
+    ScheduleStore(const ScheduleStore&) = delete;
+    ScheduleStore& operator=(const ScheduleStore&) = delete;
+
+    // true if a section of `count` entries of `width` bytes at `off` is aligned and inside the file
+    bool sectionFits(uint64_t off, uint64_t count, uint64_t width) const {
+        return off % width == 0 && off >= sizeof(ScheduleStoreHeader) && off <= map.size()
+            && count * width <= map.size() - off;
+    }
+
+    // true if offsets[0..count] is non-decreasing and offsets[count] bytes fit after bytesOff
+    bool offsetsFit(const uint32_t* offsets, uint32_t count, uint64_t bytesOff) const {
+        if (offsets[0] != 0) { return false; }
+        for (uint32_t i = 0; i < count; i++) {
+            if (offsets[i + 1] < offsets[i]) { return false; }
+        }
+        return bytesOff <= map.size() && offsets[count] <= map.size() - bytesOff;
+    }
+
+    // checks every section against the file size and every id against its dictionary, so nothing
+    // read through the columns afterwards can land outside the mapping
+    bool validate(const ScheduleStoreHeader* h) const {
+        uint64_t locations = h->locationCount, labels = h->labelCount;
+        uint64_t dateCount = h->dateCount, blocks = h->blockCount;
+        if (!sectionFits(h->nameOffsetsOff, locations + 1, 4) || !sectionFits(h->nameBytesOff, 0, 1)
+            || !sectionFits(h->latitudesOff, locations, 8) || !sectionFits(h->longitudesOff, locations, 8)
+            || !sectionFits(h->labelOffsetsOff, labels + 1, 4) || !sectionFits(h->labelBytesOff, 0, 1)
+            || !sectionFits(h->datesOff, dateCount, 4) || !sectionFits(h->dateBlocksOff, dateCount + 1, 4)
+            || !sectionFits(h->blockLocationsOff, blocks, 4) || !sectionFits(h->blockLabelsOff, blocks, 4)
+            || !sectionFits(h->blockStartsOff, blocks, 2) || !sectionFits(h->blockEndsOff, blocks, 2)) {
+            return false;
+        }
+
+        const char* base = map.data();
+        if (!offsetsFit((const uint32_t*)(base + h->nameOffsetsOff), h->locationCount, h->nameBytesOff)
+            || !offsetsFit((const uint32_t*)(base + h->labelOffsetsOff), h->labelCount, h->labelBytesOff)) {
+            return false;
+        }
+
+        // dates ascending (findDate binary searches them), each with a range of blocks in order
+        const uint32_t* d = (const uint32_t*)(base + h->datesOff);
+        const uint32_t* db = (const uint32_t*)(base + h->dateBlocksOff);
+        if (db[0] != 0 || db[h->dateCount] != h->blockCount) { return false; }
+        for (uint32_t i = 0; i < h->dateCount; i++) {
+            if (db[i + 1] < db[i] || (i > 0 && d[i] <= d[i - 1])) { return false; }
+        }
+
+        const uint32_t* bl = (const uint32_t*)(base + h->blockLocationsOff);
+        const uint32_t* bt = (const uint32_t*)(base + h->blockLabelsOff);
+        for (uint32_t b = 0; b < h->blockCount; b++) {
+            if (bl[b] >= h->locationCount || bt[b] >= h->labelCount) { return false; }
+        }
+        return true;
+    }
+
+    // returns 0 on fail (missing file, wrong format/version/byte order, truncated, or a section
+    // or id that points outside the file), 1 on success
+    int open(const std::string& path) {
+        header = NULL;
+        if (!map.open(path.c_str()) || map.size() < sizeof(ScheduleStoreHeader)) { return 0; }
+
+        const ScheduleStoreHeader* h = (const ScheduleStoreHeader*)map.data();
+        if (h->magic != STORE_MAGIC || h->version != STORE_VERSION || h->byteOrder != STORE_BYTE_ORDER
+            || h->fileSize != map.size() || !validate(h)) {
+            map.close();
+            return 0;
+        }
+
+        const char* base = map.data();
+        header = h;
+        nameOffsets = (const uint32_t*)(base + h->nameOffsetsOff);
+        nameBytes = base + h->nameBytesOff;
+        latitudes = (const double*)(base + h->latitudesOff);
+        longitudes = (const double*)(base + h->longitudesOff);
+        labelOffsets = (const uint32_t*)(base + h->labelOffsetsOff);
+        labelBytes = base + h->labelBytesOff;
+        dates = (const uint32_t*)(base + h->datesOff);
+        dateBlocks = (const uint32_t*)(base + h->dateBlocksOff);
+        blockLocations = (const uint32_t*)(base + h->blockLocationsOff);
+        blockLabels = (const uint32_t*)(base + h->blockLabelsOff);
+        blockStarts = (const uint16_t*)(base + h->blockStartsOff);
+        blockEnds = (const uint16_t*)(base + h->blockEndsOff);
+        return 1;
+    }
+
+    std::string locationName(uint32_t id) const {
+        return std::string(nameBytes + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    }
+
+    std::string label(uint32_t id) const {
+        return std::string(labelBytes + labelOffsets[id], labelOffsets[id + 1] - labelOffsets[id]);
+    }
+
+    // index of the date ("2023-12-04"), or -1 if the store doesn't have it
+    int findDate(const std::string& date) const {
+        uint32_t key = dateKey(date);
+        const uint32_t* end = dates + header->dateCount;
+        const uint32_t* it = std::lower_bound(dates, end, key);
+        return (it != end && *it == key) ? (int)(it - dates) : -1;
+    }
+
+    // adds up how many minutes each location was open across every date in the store
+    // (one pass over the block columns); `minutes` is indexed by location id
+    void totalOpenMinutes(std::vector<uint64_t>& minutes) const {
+        minutes.assign(header->locationCount, 0);
+        for (uint32_t b = 0; b < header->blockCount; b++) {
+            if (blockEnds[b] >= blockStarts[b]) {
+                minutes[blockLocations[b]] += blockEnds[b] - blockStarts[b] + 1;
+            }
+        }
+    }
+
+    // counts the dates on which location `id` was open at `minute`
+    size_t datesOpenAt(uint32_t id, int minute) const {
+        size_t count = 0;
+        for (uint32_t d = 0; d < header->dateCount; d++) {
+            for (uint32_t b = dateBlocks[d]; b < dateBlocks[d + 1]; b++) {
+                if (blockLocations[b] == id && blockStarts[b] <= minute && minute <= blockEnds[b]) {
+                    count++;
+                    break;
+                }
+            }
+        }
+        return count;
+    }
+};
+
+// immutable index for asking "what's open at minute T" (or at any point between two minutes)
+// for many values of T without going through every Location's hours each time
+//
+// every block start and end splits the day into segments within which nothing opens or closes;
+// each segment gets a bitset of the locations open during it (bit i = locations[i]), so a
+// point query is a binary search for the segment, and nothing touches the Locations afterwards
+// a block counts as open from its start through its end minute, like Location::checkIfOpen
+struct OpenIndex {
+    size_t locationCount;
+    size_t words;                // uint64_t words per bitset
+    std::vector<int> boundaries; // segment k covers minutes [boundaries[k], boundaries[k + 1])
+    std::vector<uint64_t> bits;  // segment k's bitset is bits[k*words] up to bits[(k + 1)*words]
+    std::vector<uint64_t> none;  // all zero, returned for times before the first segment
+
+    OpenIndex(const std::vector<Location>& locations)
+        : locationCount(locations.size()), words((locations.size() + 63) / 64), none(words, 0) {
+        boundaries.push_back(0);
+        for (const Location& l : locations) {
+            for (const TimeBlock& tb : l.hours) {
+                boundaries.push_back(tb.start);
+                boundaries.push_back(tb.end + 1);
+            }
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+        bits.assign(boundaries.size() * words, 0);
+        for (size_t i = 0; i < locations.size(); i++) {
+            for (const TimeBlock& tb : locations[i].hours) {
+                if (tb.end < tb.start) { continue; } // never open, as far as checkIfOpen is concerned
+                size_t first = segmentAt(tb.start);
+                size_t last = segmentAt(tb.end);
+                for (size_t k = first; k <= last; k++) {
+                    bits[k*words + i/64] |= (uint64_t)1 << (i % 64);
+                }
+            }
+        }
+    }
+
+    // index of the segment containing minute t (t must be >= 0)
+    size_t segmentAt(int t) const {
+        return std::upper_bound(boundaries.begin(), boundaries.end(), t) - boundaries.begin() - 1;
+    }
+
+    // bitset (`words` long) of the locations open at minute t, in O(log n)
+    const uint64_t* openAt(int t) const {
+        if (t < 0) { return none.data(); }
+        return &bits[segmentAt(t) * words];
+    }
+
+    bool isOpenAt(size_t location, int t) const {
+        return (openAt(t)[location / 64] >> (location % 64)) & 1;
+    }
+
+    // sets `out` to the bitset of the locations open at any point from minute `from` through `to`
+    void openDuring(int from, int to, std::vector<uint64_t>& out) const {
+        out.assign(words, 0);
+        if (to < from || to < 0) { return; }
+        size_t first = segmentAt(std::max(from, 0));
+        size_t last = segmentAt(to);
+        for (size_t k = first; k <= last; k++) {
+            for (size_t w = 0; w < words; w++) { out[w] |= bits[k*words + w]; }
+        }
+    }
+};
+
+#define EARTH_RADIUS_METERS 6371008.8
+
+// a location found by a SpatialIndex query
+struct Neighbor {
+    uint32_t location; // index into the vector the SpatialIndex was built from
+    double meters;     // great-circle distance from the query point
+};
+
+// k-d tree over the coordinates of a list of locations, for "nearest open locations to me" and
+// "open locations within r meters" in O(log n)-ish time per query
+//
+// points are stored as unit vectors on the sphere, so the straight-line (chord) distance between
+// two of them orders the same way as their great-circle distance and converts to it exactly,
+// with no haversine needed per node. the tree is a flat array (each range's median is its root),
+// and queries only write into the caller's buffers, so they don't allocate
+// locations at 0.0, 0.0 (no hardcoded coordinates) are left out
+struct SpatialIndex {
+    struct Point {
+        double v[3];
+        uint32_t location;
+    };
+    std::vector<Point> points;
+
+    SpatialIndex(const std::vector<Location>& locations) {
+        for (size_t i = 0; i < locations.size(); i++) {
+            const Location& l = locations[i];
+            if (l.latitude == 0.0 && l.longitude == 0.0) { continue; }
+            Point p;
+            toUnitVector(l.latitude, l.longitude, p.v);
+            p.location = (uint32_t)i;
+            points.push_back(p);
+        }
+        build(0, points.size(), 0);
+    }
+
+    static void toUnitVector(double latitude, double longitude, double* v) {
+        double lat = latitude * M_PI / 180.0;
+        double lon = longitude * M_PI / 180.0;
+        v[0] = cos(lat) * cos(lon);
+        v[1] = cos(lat) * sin(lon);
+        v[2] = sin(lat);
+    }
+
+    static double chordToMeters(double chord) {
+        return 2.0 * EARTH_RADIUS_METERS * asin(std::min(chord / 2.0, 1.0));
+    }
+
+    static double metersToChord(double meters) {
+        return 2.0 * sin(std::min(meters / EARTH_RADIUS_METERS, M_PI) / 2.0);
+    }
+
+    void build(size_t lo, size_t hi, int axis) {
+        if (hi - lo <= 1) { return; }
+        size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi,
+            [axis](const Point& a, const Point& b) { return a.v[axis] < b.v[axis]; });
+        build(lo, mid, (axis + 1) % 3);
+        build(mid + 1, hi, (axis + 1) % 3);
+    }
+
+    static bool isOpen(const uint64_t* openBits, uint32_t location) {
+        return openBits == NULL || ((openBits[location / 64] >> (location % 64)) & 1);
+    }
+
+    static double dist2(const double* a, const double* b) {
+        double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return dx*dx + dy*dy + dz*dz;
+    }
+
+    static bool closer(const Neighbor& a, const Neighbor& b) { return a.meters < b.meters; }
+
+    // `out` is a max-heap (by squared chord, kept in `meters` until the end) of the best so far
+    void nearest(size_t lo, size_t hi, int axis, const double* q, const uint64_t* openBits,
+                 size_t k, Neighbor* out, size_t& found) const {
+        if (lo >= hi) { return; }
+        size_t mid = lo + (hi - lo) / 2;
+        const Point& p = points[mid];
+
+        if (isOpen(openBits, p.location)) {
+            double d2 = dist2(q, p.v);
+            if (found < k) {
+                out[found++] = Neighbor{p.location, d2};
+                std::push_heap(out, out + found, closer);
+            }
+            else if (d2 < out[0].meters) {
+                std::pop_heap(out, out + found, closer);
+                out[found - 1] = Neighbor{p.location, d2};
+                std::push_heap(out, out + found, closer);
+            }
+        }
+
+        double diff = q[axis] - p.v[axis];
+        int next = (axis + 1) % 3;
+        size_t nearLo = diff < 0 ? lo : mid + 1, nearHi = diff < 0 ? mid : hi;
+        size_t farLo = diff < 0 ? mid + 1 : lo, farHi = diff < 0 ? hi : mid;
+        nearest(nearLo, nearHi, next, q, openBits, k, out, found);
+        if (found < k || diff*diff < out[0].meters) {
+            nearest(farLo, farHi, next, q, openBits, k, out, found);
+        }
+    }
+
+    // writes up to k of the locations nearest to (latitude, longitude) into out, closest first,
+    // skipping any whose bit isn't set in openBits (e.g. OpenIndex::openAt; NULL means all)
+    // returns the number written
+    size_t nearestOpen(double latitude, double longitude, const uint64_t* openBits, size_t k, Neighbor* out) const {
+        if (k == 0) { return 0; }
+        double q[3];
+        toUnitVector(latitude, longitude, q);
+        size_t found = 0;
+        nearest(0, points.size(), 0, q, openBits, k, out, found);
+        std::sort_heap(out, out + found, closer);
+        for (size_t i = 0; i < found; i++) { out[i].meters = chordToMeters(sqrt(out[i].meters)); }
+        return found;
+    }
+
+    void within(size_t lo, size_t hi, int axis, const double* q, double maxD2, const uint64_t* openBits,
+                Neighbor* out, size_t capacity, size_t& found) const {
+        if (lo >= hi) { return; }
+        size_t mid = lo + (hi - lo) / 2;
+        const Point& p = points[mid];
+
+        if (isOpen(openBits, p.location)) {
+            double d2 = dist2(q, p.v);
+            if (d2 <= maxD2) {
+                if (found < capacity) { out[found] = Neighbor{p.location, chordToMeters(sqrt(d2))}; }
+                found++;
+            }
+        }
+
+        double diff = q[axis] - p.v[axis];
+        int next = (axis + 1) % 3;
+        if (diff < 0 || diff*diff <= maxD2) { within(lo, mid, next, q, maxD2, openBits, out, capacity, found); }
+        if (diff >= 0 || diff*diff <= maxD2) { within(mid + 1, hi, next, q, maxD2, openBits, out, capacity, found); }
+    }
+
+    // writes the locations within `meters` of (latitude, longitude) into out (in no particular
+    // order), skipping any whose bit isn't set in openBits (NULL means all)
+    // returns how many there are, which may be more than `capacity` (only that many are written)
+    size_t openWithin(double latitude, double longitude, double meters, const uint64_t* openBits,
+                      Neighbor* out, size_t capacity) const {
+        double q[3];
+        toUnitVector(latitude, longitude, q);
+        double chord = metersToChord(meters);
+        size_t found = 0;
+        within(0, points.size(), 0, q, chord*chord, openBits, out, capacity, found);
+        return found;
+    }
+};
+
+// Hardcode GPS coordinates for Mizzou dining locations
+// NOTE: keep this sorted by name (in byte order, so lowercase names go last); it's binary searched,
+// and the static_assert below won't compile if it isn't sorted
+constexpr HardCodedLocation hardcodedLocations[] = {
+    {"Baja Grill", 38.943203153879246, -92.3267064269865},
+    {"Bookmark Café", 38.94444846006983, -92.32643268762787},
+    {"Do Mundo's", 38.94253788826768, -92.32686662995677},
+    {"Emporium Café", 38.94107459217775, -92.32304902570891},
+    {"Legacy Grill", 38.93918339225931, -92.33160118208086},
+    {"Mizzou Market - Southwest", 38.93921968905726, -92.33280040112133},
+    {"Mizzou Market Central", 38.94254132210812, -92.32717908392979},
+    {"Mort's", 38.9430322404151, -92.32697566673839},
+    {"Panda Express", 38.94278414251326, -92.32674715879237},
+    {"Pizza & MO", 38.94180412624759, -92.32309229325335},
+    {"Plaza 900 Dining", 38.94103367843988, -92.322668187628},
+    {"Potential Energy Café", 38.94623123277513, -92.32956715694311},
+    {"Sabai", 38.94212344437987, -92.32450920297028},
+    {"Starbucks - Memorial Union", 38.94544954634613, -92.32511273180572},
+    {"Starbucks - Southwest", 38.93916939101163, -92.33207097791104},
+    {"Subway - Southwest", 38.93916939101163, -92.33207097791104},
+    {"Sunshine Sushi", 38.9425837776428, -92.32676330297024},
+    {"The MARK on 5th Street", 38.94533889956199, -92.33233735694316},
+    {"The Restaurants at Southwest", 38.93912766582345, -92.33210316441776},
+    {"Truffles", 38.93916939101163, -92.33206024907547},
+    {"Wheatstone Bistro", 38.94548111216589, -92.3250477606413},
+    {"Wings & MO", 38.94180412624759, -92.32309229325335},
+    {"infusion", 38.9431030190833, -92.32550479820374},
+};
+
+constexpr size_t hardcodedLocationCount = sizeof(hardcodedLocations) / sizeof(hardcodedLocations[0]);
+
+// what lookups return when nothing matches
+constexpr HardCodedLocation unknownHardCodedLocation = {"", 0.0, 0.0};
+
+constexpr int constexprStrcmp(const char* a, const char* b) {
+    return (*a != *b || *a == '\0') ? (int)(unsigned char)*a - (int)(unsigned char)*b : constexprStrcmp(a + 1, b + 1);
+}
+
+constexpr bool hardcodedLocationsSorted(size_t i) {
+    return i + 1 >= hardcodedLocationCount
+        || (constexprStrcmp(hardcodedLocations[i].name, hardcodedLocations[i + 1].name) < 0
+            && hardcodedLocationsSorted(i + 1));
+}
+
+static_assert(hardcodedLocationsSorted(0), "hardcodedLocations must be sorted by name");
+
+// lowercases, strips accents ("é" -> "e"), spells out "&" and drops punctuation and extra spaces,
+// so near-misses like "Bookmark Cafe" or "pizza and mo" still match "Bookmark Café" / "Pizza & MO"
+std::string normalizeLocationName(const char* s) {
+    // ASCII replacements for U+00C0 through U+00FF ("À" through "ÿ"); ' ' means drop it
+    static const char latin1Fold[] = "aaaaaaaceeeeiiiidnooooo ouuuuytsaaaaaaaceeeeiiiidnooooo ouuuuyty";
+
+    std::string out;
+    bool pendingSpace = false;
+    // appends c, with a single space before it if there was a gap since the last char
+    auto put = [&](char c) {
+        if (pendingSpace && !out.empty()) { out += ' '; }
+        pendingSpace = false;
+        out += c;
+    };
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        unsigned char c = *p;
+        if (std::isalnum(c)) { put((char)std::tolower(c)); }
+        else if (c == '&') { pendingSpace = true; put('a'); put('n'); put('d'); pendingSpace = true; }
+        else if (std::isspace(c)) { pendingSpace = true; }
+        else if (c == 0xC3 && p[1] >= 0x80 && p[1] <= 0xBF) {
+            // a 2 byte UTF-8 char in the Latin-1 range
+            char folded = latin1Fold[p[1] - 0x80];
+            p++;
+            if (folded != ' ') { put(folded); }
+        }
+        // anything else (apostrophes, hyphens, other UTF-8) is dropped
+    }
+    return out;
+}
+
+// returns the hardcoded location with this exact name, or, failing that, one whose name matches
+// after normalizeLocationName; returns unknownHardCodedLocation (at 0.0, 0.0) if neither does
+const HardCodedLocation& findHardCodedLocation(const std::string& name) {
+    const HardCodedLocation* begin = hardcodedLocations;
+    const HardCodedLocation* end = hardcodedLocations + hardcodedLocationCount;
+    const HardCodedLocation* it = std::lower_bound(begin, end, name.c_str(),
+        [](const HardCodedLocation& hcl, const char* key) { return strcmp(hcl.name, key) < 0; });
+    if (it != end && strcmp(it->name, name.c_str()) == 0) {
+        return *it;
+    }
+
+    // the normalized names are only worked out (and sorted) the first time they're needed
+    typedef std::pair<std::string, const HardCodedLocation*> NormalizedEntry;
+    static const std::vector<NormalizedEntry> normalized = []() {
+        std::vector<NormalizedEntry> entries;
+        for (const HardCodedLocation& hcl : hardcodedLocations) {
+            entries.push_back(NormalizedEntry(normalizeLocationName(hcl.name), &hcl));
+        }
+        std::sort(entries.begin(), entries.end());
+        return entries;
+    }();
+
+    std::string key = normalizeLocationName(name.c_str());
+    auto nit = std::lower_bound(normalized.begin(), normalized.end(), key,
+        [](const NormalizedEntry& entry, const std::string& k) { return entry.first < k; });
+    if (nit != normalized.end() && nit->first == key) {
+        return *nit->second;
+    }
+    return unknownHardCodedLocation;
+}
+
+// fills in the coordinates of every location that has a hardcoded one
+// (the rest keep 0.0, 0.0)
+void applyHardCodedCoordinates(std::vector<Location>& locations) {
+    for (Location& l : locations) {
+        const HardCodedLocation& hcl = findHardCodedLocation(l.name);
+        if (&hcl != &unknownHardCodedLocation) {
+            l.latitude = hcl.latitude;
+            l.longitude = hcl.longitude;
+        }
+    }
+}
+
+// chop off n chars from end of s
+void rchop(std::string& s, int n) {
+    s.erase(s.size() - n, n);
+}
+
+// THIS IS ONLY USED IN THE ANDROID VERSION (for passing C++ data to Java)
+//
+// output looks like:
+// [location]||||[location]||||...
+//
+// [location] looks like:
+// Baja Grill|||38.943203153879246|||-92.3267064269865|||[strHours]|||0|||1|||[timeBlocks]
+//
+// [timeBlocks] looks like:
+// Lunch|100|200||Dinner|300|400||Late-night|500|600||...
+//
+// if `open` isn't NULL, bit i of it (an OpenIndex bitset) is written as locations[i]'s 'open'
+// instead of its flag, so a shared list can be written without copying it to set the flags
+std::string serializeLocations(const std::vector<Location>& locations, const uint64_t* open = NULL) {
+    std::string out;
+    
+    // extract each Location
+
+    for (size_t i = 0; i < locations.size(); i++) {
+        const Location& l = locations[i];
+        bool isOpen = open ? (open[i / 64] >> (i % 64)) & 1 : l.open;
+        std::string serializedLoc;
+
+        // extract each Location parameter
+
+        // for (int i = 0; i < 7; i++) {
+        //     
+        //     serializedLoc += "|||";
+        // }
+        {
+            serializedLoc += l.name + "|||";
+            serializedLoc += std::to_string(l.latitude) + "|||";
+            serializedLoc += std::to_string(l.longitude) + "|||";
+            serializedLoc += l.strHours() + "|||";
+            serializedLoc += std::to_string(l.favorite) + "|||";
+            serializedLoc += std::to_string(isOpen) + "|||";
+
+            // extract each TimeBlock
+            for (const TimeBlock& tb : l.hours) {
+                // extract each TimeBlock parameter
+                {
+                    serializedLoc += tb.label + "|";
+                    serializedLoc += std::to_string(tb.start) + "|";
+                    serializedLoc += std::to_string(tb.end);
+                    // at the end, don't add a final "|"
+                }
+
+                serializedLoc += "||";
+            }
+            rchop(serializedLoc, 2);
+
+        }
+        // rchop(out, 3); // chop off trailing delim
+
+        out += serializedLoc + "||||";
+    }
+    rchop(out, 4); // chop off trailing delim
+
+    return out;
+}
+
+#define LOCATIONS_BINARY_MAGIC 0x4c445a4d // "MZDL" when read as little-endian bytes
+#define LOCATIONS_BINARY_VERSION 1
+
+// THIS IS ONLY USED IN THE ANDROID VERSION (for passing C++ data to Java)
+// a binary alternative to serializeLocations that Java can read straight out of a ByteBuffer
+// (with ByteOrder.LITTLE_ENDIAN) instead of splitting and re-parsing strings
+//
+// everything is little-endian; strings are UTF-8 and referenced by index into the string table
+//
+// header:
+//   u32 magic ("MZDL"), u16 version, u16 reserved (0), u32 string count, u32 location count
+// string table, once per string:
+//   u32 byte length, then the bytes (no terminator)
+// locations, once per location:
+//   u32 name index, f64 latitude, f64 longitude, u8 flags (1 = favorite, 2 = open),
+//   u8 reserved (0), u16 block count, then per block: u32 label index, u16 start, u16 end
+//
+// strHours isn't included since it can be rebuilt from the blocks; block labels ("Lunch",
+// "Dinner", ...) are only stored once
+void putU16(char*& p, uint16_t v) {
+    p[0] = (char)(v & 0xff); p[1] = (char)(v >> 8);
+    p += 2;
+}
+
+void putU32(char*& p, uint32_t v) {
+    for (int i = 0; i < 4; i++) { p[i] = (char)((v >> (8*i)) & 0xff); }
+    p += 4;
+}
+
+void putF64(char*& p, double d) {
+    uint64_t v;
+    memcpy(&v, &d, sizeof(v));
+    for (int i = 0; i < 8; i++) { p[i] = (char)((v >> (8*i)) & 0xff); }
+    p += 8;
+}
+
+std::string serializeLocationsBinary(const std::vector<Location>& locations) {
+    // build the string table: every name (in location order), then each distinct label
+    // (there's only a handful of distinct labels, so a linear search is fine)
+    std::vector<const std::string*> strings;
+    std::vector<uint32_t> labelIdxs; // one per block, in order
+    size_t size = 16;
+    for (const Location& l : locations) {
+        strings.push_back(&l.name);
+        size += 4 + l.name.size();
+        size += 4 + 8 + 8 + 1 + 1 + 2;
+    }
+    for (const Location& l : locations) {
+        for (const TimeBlock& tb : l.hours) {
+            size_t idx = locations.size(); // labels come after the names
+            while (idx < strings.size() && *strings[idx] != tb.label) { idx++; }
+            if (idx == strings.size()) {
+                strings.push_back(&tb.label);
+                size += 4 + tb.label.size();
+            }
+            labelIdxs.push_back((uint32_t)idx);
+            size += 4 + 2 + 2;
+        }
+    }
+
+    std::string out(size, '\0');
+    char* p = &out[0];
+    putU32(p, LOCATIONS_BINARY_MAGIC);
+    putU16(p, LOCATIONS_BINARY_VERSION);
+    putU16(p, 0);
+    putU32(p, (uint32_t)strings.size());
+    putU32(p, (uint32_t)locations.size());
+
+    for (const std::string* s : strings) {
+        putU32(p, (uint32_t)s->size());
+        memcpy(p, s->data(), s->size());
+        p += s->size();
+    }
+
+    size_t blockIdx = 0;
+    for (size_t i = 0; i < locations.size(); i++) {
+        const Location& l = locations[i];
+        putU32(p, (uint32_t)i);
+        putF64(p, l.latitude);
+        putF64(p, l.longitude);
+        *p++ = (char)((l.favorite ? 1 : 0) | (l.open ? 2 : 0));
+        *p++ = 0;
+        putU16(p, (uint16_t)l.hours.size());
+        for (const TimeBlock& tb : l.hours) {
+            putU32(p, labelIdxs[blockIdx++]);
+            putU16(p, (uint16_t)tb.start);
+            putU16(p, (uint16_t)tb.end);
+        }
+    }
+
+    return out;
+}
+
+// reads little-endian values out of a serializeLocationsBinary buffer, failing instead of
+// reading past the end
+struct BinaryReader {
+    const unsigned char* p;
+    const unsigned char* end;
+
+    bool has(size_t n) const { return (size_t)(end - p) >= n; }
+
+    bool u8(uint8_t& v) {
+        if (!has(1)) { return false; }
+        v = *p++;
+        return true;
+    }
+
+    bool u16(uint16_t& v) {
+        if (!has(2)) { return false; }
+        v = (uint16_t)(p[0] | (p[1] << 8));
+        p += 2;
+        return true;
+    }
+
+    bool u32(uint32_t& v) {
+        if (!has(4)) { return false; }
+        v = 0;
+        for (int i = 0; i < 4; i++) { v |= (uint32_t)p[i] << (8*i); }
+        p += 4;
+        return true;
+    }
+
+    bool f64(double& d) {
+        if (!has(8)) { return false; }
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) { v |= (uint64_t)p[i] << (8*i); }
+        memcpy(&d, &v, sizeof(d));
+        p += 8;
+        return true;
+    }
+};
+
+// decodes a serializeLocationsBinary buffer back into Locations (strHours is rebuilt)
+// returns 0 on fail (bad magic, unknown version, or truncated/corrupt data), 1 on success
+int deserializeLocationsBinary(const char* data, size_t len, std::vector<Location>& out) {
+    BinaryReader r{(const unsigned char*)data, (const unsigned char*)data + len};
+
+    uint32_t magic, stringCount, locationCount;
+    uint16_t version, reserved;
+    if (!r.u32(magic) || magic != LOCATIONS_BINARY_MAGIC) { return 0; }
+    if (!r.u16(version) || version != LOCATIONS_BINARY_VERSION) { return 0; }
+    if (!r.u16(reserved) || !r.u32(stringCount) || !r.u32(locationCount)) { return 0; }
+
+    // every string takes at least 4 bytes, so a bogus count can't make us allocate much
+    if (!r.has((size_t)stringCount * 4)) { return 0; }
+    std::vector<std::string> strings;
+    strings.reserve(stringCount);
+    for (uint32_t i = 0; i < stringCount; i++) {
+        uint32_t n;
+        if (!r.u32(n) || !r.has(n)) { return 0; }
+        strings.push_back(std::string((const char*)r.p, n));
+        r.p += n;
+    }
+
+    if (!r.has((size_t)locationCount * 24)) { return 0; }
+    out.clear();
+    out.reserve(locationCount);
+    std::vector<TimeBlock> hours;
+    for (uint32_t i = 0; i < locationCount; i++) {
+        uint32_t nameIdx;
+        double latitude, longitude;
+        uint8_t flags, pad;
+        uint16_t blockCount;
+        if (!r.u32(nameIdx) || nameIdx >= strings.size()) { return 0; }
+        if (!r.f64(latitude) || !r.f64(longitude)) { return 0; }
+        if (!r.u8(flags) || !r.u8(pad) || !r.u16(blockCount)) { return 0; }
+
+        hours.clear();
+        for (uint16_t b = 0; b < blockCount; b++) {
+            uint32_t labelIdx;
+            uint16_t start, end;
+            if (!r.u32(labelIdx) || labelIdx >= strings.size() || !r.u16(start) || !r.u16(end)) { return 0; }
+            hours.push_back(TimeBlock{strings[labelIdx], start, end});
+        }
+
+        Location l{strings[nameIdx], latitude, longitude, hours};
+        l.favorite = (flags & 1) != 0;
+        l.open = (flags & 2) != 0;
+        out.push_back(l);
+    }
+
+    return 1;
+}
+
+// THIS IS ONLY USED IN THE ANDROID VERSION (for passing C++ data to Java)
+// fills the caller's flat arrays (see MizzouLocationArrays in MizzouDining.h) from `locations`,
+// so nothing needs to be serialized or re-parsed on the other side
+// returns 1 on success, 0 if the arrays are too small (only the counts are filled in then)
+int exportLocationArrays(const std::vector<Location>& locations, MizzouLocationArrays* out) {
+    // count everything first, with labels deduplicated after the names like serializeLocationsBinary
+    std::vector<const std::string*> labels;
+    size_t strBytes = 0;
+    size_t blocks = 0;
+    for (const Location& l : locations) {
+        strBytes += l.name.size();
+        for (const TimeBlock& tb : l.hours) {
+            size_t idx = 0;
+            while (idx < labels.size() && *labels[idx] != tb.label) { idx++; }
+            if (idx == labels.size()) {
+                labels.push_back(&tb.label);
+                strBytes += tb.label.size();
+            }
+            blocks++;
+        }
+    }
+
+    out->locationCount = (uint32_t)locations.size();
+    out->stringCount = (uint32_t)(locations.size() + labels.size());
+    out->strByteCount = (uint32_t)strBytes;
+    out->blockCount = (uint32_t)blocks;
+    if (out->locationCount > out->locationCapacity || out->stringCount > out->stringCapacity
+        || out->strByteCount > out->strByteCapacity || out->blockCount > out->blockCapacity) {
+        return 0;
+    }
+
+    uint32_t strIdx = 0;
+    uint32_t byteIdx = 0;
+    for (const Location& l : locations) {
+        out->strOffsets[strIdx++] = byteIdx;
+        memcpy(out->strBytes + byteIdx, l.name.data(), l.name.size());
+        byteIdx += l.name.size();
+    }
+    for (const std::string* label : labels) {
+        out->strOffsets[strIdx++] = byteIdx;
+        memcpy(out->strBytes + byteIdx, label->data(), label->size());
+        byteIdx += label->size();
+    }
+    out->strOffsets[strIdx] = byteIdx;
+
+    memset(out->openBits, 0, (locations.size() + 7) / 8);
+    memset(out->favoriteBits, 0, (locations.size() + 7) / 8);
+    uint32_t blockIdx = 0;
+    for (size_t i = 0; i < locations.size(); i++) {
+        const Location& l = locations[i];
+        out->latitudes[i] = l.latitude;
+        out->longitudes[i] = l.longitude;
+        if (l.open) { out->openBits[i / 8] |= (uint8_t)(1 << (i % 8)); }
+        if (l.favorite) { out->favoriteBits[i / 8] |= (uint8_t)(1 << (i % 8)); }
+
+        out->blockOffsets[i] = blockIdx;
+        for (const TimeBlock& tb : l.hours) {
+            uint32_t labelIdx = 0;
+            while (*labels[labelIdx] != tb.label) { labelIdx++; }
+            out->blockStarts[blockIdx] = (uint16_t)tb.start;
+            out->blockEnds[blockIdx] = (uint16_t)tb.end;
+            out->blockLabels[blockIdx] = (uint32_t)(locations.size() + labelIdx);
+            blockIdx++;
+        }
+    }
+    out->blockOffsets[locations.size()] = blockIdx;
+
+    return 1;
+}
+
+struct MizzouSchedule {
+    std::string date;
+    int debugMode;
+    std::vector<Location> locations;
+};
+
+extern "C" MizzouSchedule* mizzou_fetch_schedule(const char* date, int debugMode) {
+    std::unique_ptr<MizzouSchedule> schedule(new MizzouSchedule());
+    schedule->date = date;
+    schedule->debugMode = debugMode;
+    if (!fetchScheduleData(date, debugMode != 0, schedule->locations)) { return NULL; }
+    evaluateOpenStatus(schedule->locations, ClockSnapshot::now());
+    applyHardCodedCoordinates(schedule->locations);
+    return schedule.release();
+}
+
+extern "C" int mizzou_export(const MizzouSchedule* schedule, MizzouLocationArrays* out) {
+    return exportLocationArrays(schedule->locations, out) ? MIZZOU_EXPORT_OK : MIZZOU_EXPORT_TOO_SMALL;
+}
+
+extern "C" void mizzou_free_schedule(MizzouSchedule* schedule) {
+    delete schedule;
+}
+
+extern "C" int mizzou_export_schedule(const char* date, int debugMode, MizzouLocationArrays* out) {
+    // the schedule from a call whose arrays were too small, waiting for the retry
+    static std::mutex pendingMutex;
+    static std::unique_ptr<MizzouSchedule> pending;
+
+    std::unique_ptr<MizzouSchedule> schedule;
+    {
+        std::lock_guard<std::mutex> guard(pendingMutex);
+        if (pending && pending->date == date && pending->debugMode == debugMode) { schedule.swap(pending); }
+    }
+    if (!schedule) {
+        schedule.reset(mizzou_fetch_schedule(date, debugMode));
+        if (!schedule) { return MIZZOU_EXPORT_FETCH_FAILED; }
+    }
+
+    int result = mizzou_export(schedule.get(), out);
+    if (result == MIZZOU_EXPORT_TOO_SMALL) {
+        std::lock_guard<std::mutex> guard(pendingMutex);
+        pending.swap(schedule);
+    }
+    return result;
+}
+
+// today's date in the format the dining site takes, like "2023-12-04"
+std::string todayDateStr() {
+    time_t t = time(NULL);
+    struct tm tmVal;
+    localtime_r(&t, &tmVal);
+    char buf[16];
+    strftime(buf, sizeof(buf), "%Y-%m-%d", &tmVal);
+    return buf;
+}
+
+// one fetch of the schedule as the server hands it out; built once per refresh and never
+// modified afterwards, so any number of request threads can read it at the same time
+struct ScheduleSnapshot {
+    std::string date;
+    time_t fetched;
+    std::vector<Location> locations; // hardcoded coordinates already applied
+    OpenIndex openIndex;             // for /open, so requests don't walk every Location's hours
+
+    ScheduleSnapshot(const std::string& _date, std::vector<Location>& _locations)
+        : date(_date), fetched(time(NULL)), openIndex(_locations) {
+        locations.swap(_locations);
+    }
+};
+
+// holds the current ScheduleSnapshot so readers never take a lock or contend with the writer,
+// RCU style: publish() swaps in the new snapshot with one atomic exchange, then waits until no
+// reader can still be looking at the old one before freeing it
+//
+// readers register on one of two counters, picked by the parity of `epoch`; publish() bumps the
+// epoch (so new readers go to the other counter) and waits for the old counter to drain. A reader
+// re-checks the epoch after registering and retries if it moved, so it can never end up counted
+// on a side the writer has already finished waiting on
+struct PublishedSnapshot {
+    std::atomic<const ScheduleSnapshot*> current;
+    std::atomic<unsigned> epoch;
+    struct alignas(64) ReaderCount { std::atomic<long> n; }; // own cache line each
+    ReaderCount readers[2];
+    std::mutex writerMutex; // only serializes publishers
+
+    PublishedSnapshot() : current(NULL), epoch(0) {
+        readers[0].n = 0;
+        readers[1].n = 0;
+    }
+
+    PublishedSnapshot(const PublishedSnapshot&) = delete;
+    PublishedSnapshot& operator=(const PublishedSnapshot&) = delete;
+
+    ~PublishedSnapshot() {
+        delete current.load();
+    }
+
+    // a reader's view of the snapshot; it stays valid (and won't be freed) until this goes away,
+    // so don't hold one longer than a single request
+    struct ReadGuard {
+        PublishedSnapshot& owner;
+        unsigned side;
+        const ScheduleSnapshot* snapshot; // NULL if nothing was published yet
+
+        ReadGuard(PublishedSnapshot& _owner) : owner(_owner) {
+            for (;;) {
+                unsigned e = owner.epoch.load();
+                side = e & 1;
+                owner.readers[side].n.fetch_add(1);
+                if (owner.epoch.load() == e) { break; }
+                owner.readers[side].n.fetch_sub(1); // a publish moved the epoch, go to the new side
+            }
+            snapshot = owner.current.load();
+        }
+
+        ~ReadGuard() {
+            owner.readers[side].n.fetch_sub(1);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const ScheduleSnapshot* operator->() const { return snapshot; }
+        const ScheduleSnapshot* get() const { return snapshot; }
+    };
+
+    // makes s the current snapshot; returns once the previous one has been freed
+    void publish(std::unique_ptr<const ScheduleSnapshot> s) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        const ScheduleSnapshot* old = current.exchange(s.release());
+        unsigned e = epoch.fetch_add(1);
+        while (readers[e & 1].n.load() != 0) {
+            std::this_thread::yield();
+        }
+        delete old;
+    }
+};
+
+// long-running mode: keeps the last good ScheduleSnapshot in memory and serves it over HTTP,
+// while a background thread refreshes it every `refreshSeconds`
+//
+// requests are always answered from whatever snapshot is current, so they never wait on the
+// network; a refresh that fails leaves the previous snapshot in place (stale-while-revalidate)
+//
+// GET /locations -> serializeLocations() of the snapshot, with 'open' evaluated at request time
+// GET /open      -> names of the locations open right now, one per line
+// both send an Age header (seconds since the snapshot was fetched) and 503 until the first
+// fetch succeeds
+// `host` (and `cache`) can be pointed at a local server for testing
+struct ScheduleServer {
+    std::string date; // empty to follow today's date
+    bool debugMode;
+    int refreshSeconds;
+    std::string host;
+    ScheduleCache& cache;
+
+    httplib::Server server;
+    PublishedSnapshot snapshot; // request threads read it without locking
+
+    std::thread refresher;
+    std::mutex stopMutex;
+    std::condition_variable stopCond;
+    bool stopping;
+
+    ScheduleServer(const std::string& _date, bool _debugMode, int _refreshSeconds,
+                   const std::string& _host = DINING_HOST, ScheduleCache& _cache = scheduleCache())
+        : date(_date), debugMode(_debugMode), refreshSeconds(_refreshSeconds), host(_host), cache(_cache),
+          stopping(false) {
+        server.Get("/locations", [this](const httplib::Request&, httplib::Response& res) {
+            PublishedSnapshot::ReadGuard s(snapshot);
+            if (!respondIfMissing(s.get(), res)) { return; }
+            const uint64_t* open = s->openIndex.openAt(ClockSnapshot::now().nowInt);
+            res.set_content(serializeLocations(s->locations, open), "text/plain");
+        });
+        server.Get("/open", [this](const httplib::Request&, httplib::Response& res) {
+            PublishedSnapshot::ReadGuard s(snapshot);
+            if (!respondIfMissing(s.get(), res)) { return; }
+            const uint64_t* open = s->openIndex.openAt(ClockSnapshot::now().nowInt);
+            std::string body;
+            for (size_t i = 0; i < s->locations.size(); i++) {
+                if ((open[i / 64] >> (i % 64)) & 1) { body += s->locations[i].name + "\n"; }
+            }
+            res.set_content(body, "text/plain");
+        });
+    }
+
+    ScheduleServer(const ScheduleServer&) = delete;
+    ScheduleServer& operator=(const ScheduleServer&) = delete;
+
+    ~ScheduleServer() {
+        stop();
+        if (refresher.joinable()) { refresher.join(); }
+    }
+
+    // returns false (after filling in a 503) if there's nothing to serve yet
+    bool respondIfMissing(const ScheduleSnapshot* s, httplib::Response& res) {
+        if (!s) {
+            res.status = 503;
+            res.set_content("Schedule not fetched yet\n", "text/plain");
+            return false;
+        }
+        res.set_header("Age", std::to_string((long long)(time(NULL) - s->fetched)));
+        return true;
+    }
+
+    // fetches the schedule and, if that worked, makes it the current snapshot; the cached page is
+    // always revalidated, since refreshSeconds may well be shorter than CACHE_MAX_AGE
+    // returns 0 on fail (the previous snapshot stays current), 1 on success
+    int refresh() {
+        std::string fetchDate = date.empty() ? todayDateStr() : date;
+        std::vector<Location> locations;
+        int ok = debugMode ? fetchScheduleData(fetchDate, true, locations)
+                           : fetchThroughCache(cache, host, fetchDate, false, locations, true);
+        if (!ok || locations.empty()) {
+            std::cerr << "Refresh failed, still serving the previous schedule." << std::endl;
+            return 0;
+        }
+        applyHardCodedCoordinates(locations);
+        snapshot.publish(std::unique_ptr<const ScheduleSnapshot>(new ScheduleSnapshot(fetchDate, locations)));
+        return 1;
+    }
+
+    void refreshLoop() {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!stopping) {
+            lock.unlock();
+            refresh();
+            lock.lock();
+            stopCond.wait_for(lock, std::chrono::seconds(refreshSeconds), [this] { return stopping; });
+        }
+    }
+
+    // starts refreshing in the background and serves until stop() is called
+    // returns 0 on fail (couldn't listen on the port), 1 on success
+    int run(const char* host, int port) {
+        refresher = std::thread(&ScheduleServer::refreshLoop, this);
+        bool ok = server.listen(host, port);
+        stop();
+        refresher.join();
+        return ok ? 1 : 0;
+    }
+
+    // makes run() return (from any thread)
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            stopping = true;
+        }
+        stopCond.notify_all();
+        server.stop();
+    }
+};
+
+int main() {
+    std::string date = "2023-12-04";  // Replace with the desired date
+
+    // libxml2's global state is torn down once on the way out; it isn't safe to do after each
+    // parse, since other threads may still be parsing
+    atexit(xmlCleanupParser);
+
+    if (D_SERVE) {
+        ScheduleServer scheduleServer(D_MODE ? date : "", D_MODE, REFRESH_INTERVAL);
+        std::cout << "Serving on port " << SERVE_PORT << std::endl;
+        if (!scheduleServer.run("0.0.0.0", SERVE_PORT)) {
+            std::cerr << "Could not listen on port " << SERVE_PORT << "." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    std::vector<Location> locations = D_STREAM ? StreamScheduleData(date, D_MODE) : GetScheduleData(date, D_MODE);
+
+    // std::vector<TimeBlock> testTimeBlocks = parseHrsStr("10:00 AM - 3:00 PM");
+    // Location testLoc{"Test", 0.0, 0.0, testTimeBlocks};
+    // testLoc.checkIfOpen();
+    // locations.push_back(testLoc);
+
+    // Match locations with corresponding hardcoded coordinates
+    applyHardCodedCoordinates(locations);
+
+    std::cout << "Successfully parsed\n";
+    std::cout << "List of locations:\n";
+    std::cout << "====================\n";
+    // Print information
+    if (locations.empty()) {
+        std::cout << "Locations vector is empty" << std::endl;
+    }
+    else {
+        for (const auto& location : locations) {
+            std::cout << "Name: " << location.name << std::endl;
+            std::cout << location.strHours();
+            std::cout << "Open: " << (location.open ? "Yes" : "No") << std::endl;
+            std::cout << "GPS Coordinates: " << location.latitude << ", " << location.longitude << std::endl;
+            std::cout << "====================\n";
+        }
+    }
+
+    if (!D_MODE) {
+        ScheduleCacheStats cacheStats = scheduleCacheStats();
+        std::cout << "Cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, "
+                  << cacheStats.revalidations << " revalidated\n";
     }
 
     // std::cout << serializeLocations(locations) << "\n";
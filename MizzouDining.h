@@ -0,0 +1,76 @@
+// C interface to MizzouDining.cpp, for the Android bridge
+// (it's plain C so it can also be driven from a C program instead of the JVM)
+
+#ifndef MIZZOU_DINING_H
+#define MIZZOU_DINING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// flat arrays describing a list of locations, filled in a single call with no per-field allocation
+// the caller owns every array and sets the capacities; on the Java side each one can be a direct
+// ByteBuffer (in native byte order)
+//
+// strings (names, then each distinct block label) are stored back to back in `strBytes`,
+// string i being strBytes[strOffsets[i]] up to strBytes[strOffsets[i + 1]] (UTF-8, no terminator)
+// location i is named by string i, and its blocks are blockOffsets[i] up to blockOffsets[i + 1]
+typedef struct MizzouLocationArrays {
+    // set by the caller
+    uint32_t locationCapacity; // entries in latitudes/longitudes (+1 for blockOffsets)
+    uint32_t stringCapacity;   // entries in strOffsets, minus 1
+    uint32_t strByteCapacity;  // bytes in strBytes
+    uint32_t blockCapacity;    // entries in blockStarts/blockEnds/blockLabels
+
+    // set by the export; if any capacity is too small, only these are filled in so the caller
+    // can grow its arrays and try again
+    uint32_t locationCount;
+    uint32_t stringCount;
+    uint32_t strByteCount;
+    uint32_t blockCount;
+
+    char* strBytes;
+    uint32_t* strOffsets;   // stringCapacity + 1
+    double* latitudes;      // locationCapacity
+    double* longitudes;     // locationCapacity
+    uint32_t* blockOffsets; // locationCapacity + 1
+    uint16_t* blockStarts;  // blockCapacity, minutes since the start of the day
+    uint16_t* blockEnds;    // blockCapacity
+    uint32_t* blockLabels;  // blockCapacity, string index
+    uint8_t* openBits;      // (locationCapacity + 7) / 8 bytes, bit i set if location i is open
+    uint8_t* favoriteBits;  // (locationCapacity + 7) / 8 bytes
+} MizzouLocationArrays;
+
+// what the export functions return
+#define MIZZOU_EXPORT_OK 1
+#define MIZZOU_EXPORT_TOO_SMALL 0      // the counts in `out` say how big the arrays must be
+#define MIZZOU_EXPORT_FETCH_FAILED (-1) // the schedule couldn't be fetched or parsed
+
+// a fetched schedule, held by the caller so it can be exported any number of times (e.g. once to
+// learn the sizes and again into arrays that big) without fetching it again in between
+typedef struct MizzouSchedule MizzouSchedule;
+
+// fetches the schedule for `date` ("2023-12-04"), with hardcoded coordinates and 'open' evaluated
+// (debugMode reads the cached locations.html instead of the network)
+// returns NULL if it couldn't be fetched or parsed; free it with mizzou_free_schedule
+MizzouSchedule* mizzou_fetch_schedule(const char* date, int debugMode);
+
+// exports a fetched schedule into `out`
+// returns MIZZOU_EXPORT_OK or MIZZOU_EXPORT_TOO_SMALL
+int mizzou_export(const MizzouSchedule* schedule, MizzouLocationArrays* out);
+
+void mizzou_free_schedule(MizzouSchedule* schedule);
+
+// fetches the schedule for `date` and exports it into `out` in one call
+// when the arrays are too small, the fetched schedule is kept and the next call for the same
+// date and debugMode exports that instead of fetching again, so the counts it reported still hold
+// returns MIZZOU_EXPORT_OK, MIZZOU_EXPORT_TOO_SMALL or MIZZOU_EXPORT_FETCH_FAILED
+int mizzou_export_schedule(const char* date, int debugMode, MizzouLocationArrays* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
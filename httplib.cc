@@ -260,11 +260,21 @@ void read_file(const std::string &path, std::string &out) {
   fs.read(&out[0], static_cast<std::streamsize>(size));
 }
 
+bool is_alnum(char c) {
+  return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') ||
+         ('A' <= c && c <= 'Z');
+}
+
+// The [a-zA-Z0-9]+ run at the end of path, if there's a '.' right before it
 std::string file_extension(const std::string &path) {
-  std::smatch m;
-  static auto re = std::regex("\\.([a-zA-Z0-9]+)$");
-  if (std::regex_search(path, m, re)) { return m[1].str(); }
-  return std::string();
+  auto i = path.size();
+  while (i > 0 && is_alnum(path[i - 1])) {
+    i--;
+  }
+  if (i == path.size() || i == 0 || path[i - 1] != '.') {
+    return std::string();
+  }
+  return path.substr(i);
 }
 
 bool is_space_or_tab(char c) { return c == ' ' || c == '\t'; }
@@ -421,6 +431,7 @@ bool mmap::open(const char *path) {
   size_ = static_cast<size_t>(sb.st_size);
 
   addr_ = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (addr_ == MAP_FAILED) { addr_ = nullptr; }
 #endif
 
   if (addr_ == nullptr) {
@@ -646,6 +657,8 @@ public:
   void get_remote_ip_and_port(std::string &ip, int &port) const override;
   void get_local_ip_and_port(std::string &ip, int &port) const override;
   socket_t socket() const override;
+  ssize_t peek(const char *&ptr) override;
+  void skip(size_t size) override;
 
 private:
   socket_t sock_;
@@ -654,11 +667,12 @@ private:
   time_t write_timeout_sec_;
   time_t write_timeout_usec_;
 
-  std::vector<char> read_buff_;
+  static const size_t read_buff_size_ = 1024l * 4;
+
+  // Inline, since the server makes a SocketStream for every request
+  std::array<char, read_buff_size_> read_buff_;
   size_t read_buff_off_ = 0;
   size_t read_buff_content_size_ = 0;
-
-  static const size_t read_buff_size_ = 1024l * 4;
 };
 
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
@@ -1499,7 +1513,9 @@ bool parse_header(const char *beg, const char *end, T fn) {
 
   if (p < end) {
     auto key = std::string(beg, key_end);
-    auto val = compare_case_ignore(key, "Location")
+    // Values without escapes decode to themselves
+    auto val = compare_case_ignore(key, "Location") ||
+                       !memchr(p, '%', static_cast<size_t>(end - p))
                    ? std::string(p, end)
                    : decode_url(std::string(p, end), false);
     fn(std::move(key), std::move(val));
@@ -2047,47 +2063,84 @@ void parse_disposition_params(const std::string &s, Params &params) {
   });
 }
 
-#ifdef CPPHTTPLIB_NO_EXCEPTIONS
+// Accepts the same syntax as bytes=(\d*-\d*(?:,\s*\d*-\d*)*)
 bool parse_range_header(const std::string &s, Ranges &ranges) {
-#else
-bool parse_range_header(const std::string &s, Ranges &ranges) try {
-#endif
-  static auto re_first_range = std::regex(R"(bytes=(\d*-\d*(?:,\s*\d*-\d*)*))");
-  std::smatch m;
-  if (std::regex_match(s, m, re_first_range)) {
-    auto pos = static_cast<size_t>(m.position(1));
-    auto len = static_cast<size_t>(m.length(1));
-    auto all_valid_ranges = true;
-    split(&s[pos], &s[pos + len], ',', [&](const char *b, const char *e) {
-      if (!all_valid_ranges) return;
-      static auto re_another_range = std::regex(R"(\s*(\d*)-(\d*))");
-      std::cmatch cm;
-      if (std::regex_match(b, e, cm, re_another_range)) {
-        ssize_t first = -1;
-        if (!cm.str(1).empty()) {
-          first = static_cast<ssize_t>(std::stoll(cm.str(1)));
-        }
+  static const char prefix[] = "bytes=";
+  if (s.compare(0, sizeof(prefix) - 1, prefix) != 0) { return false; }
+
+  auto p = s.data() + sizeof(prefix) - 1;
+  auto end = s.data() + s.size();
+
+  // -1 if there are no digits, -2 if the number doesn't fit
+  auto parse_number = [&]() -> ssize_t {
+    if (p == end || *p < '0' || '9' < *p) { return -1; }
+    ssize_t v = 0;
+    for (; p < end && '0' <= *p && *p <= '9'; p++) {
+      auto d = *p - '0';
+      if (v > ((std::numeric_limits<ssize_t>::max)() - d) / 10) { return -2; }
+      v = v * 10 + d;
+    }
+    return v;
+  };
 
-        ssize_t last = -1;
-        if (!cm.str(2).empty()) {
-          last = static_cast<ssize_t>(std::stoll(cm.str(2)));
-        }
+  Ranges parsed;
+  for (;;) {
+    auto first = parse_number();
+    if (first == -2 || p == end || *p != '-') { return false; }
+    p++;
+    auto last = parse_number();
+    if (last == -2) { return false; }
+    if (first != -1 && last != -1 && first > last) { return false; }
+    parsed.emplace_back(first, last);
 
-        if (first != -1 && last != -1 && first > last) {
-          all_valid_ranges = false;
-          return;
-        }
-        ranges.emplace_back(std::make_pair(first, last));
-      }
-    });
-    return all_valid_ranges;
+    if (p == end) { break; }
+    if (*p != ',') { return false; }
+    p++;
+    while (p < end && (*p == ' ' || ('\t' <= *p && *p <= '\r'))) {
+      p++;
+    }
   }
-  return false;
-#ifdef CPPHTTPLIB_NO_EXCEPTIONS
+
+  ranges.insert(ranges.end(), parsed.begin(), parsed.end());
+  return true;
 }
-#else
-} catch (...) { return false; }
+
+// Parses a status line like "HTTP/1.1 200 OK\r\n" (line terminator included)
+bool parse_status_line(const char *b, const char *e, std::string &version,
+                       int &status, std::string &reason) {
+  if (e - b >= 2 && e[-2] == '\r' && e[-1] == '\n') {
+    e -= 2;
+#ifdef CPPHTTPLIB_ALLOW_LF_AS_LINE_TERMINATOR
+  } else if (e - b >= 1 && e[-1] == '\n') {
+    e -= 1;
 #endif
+  } else {
+    return false;
+  }
+
+  // "HTTP/1.x NNN"
+  if (e - b < 12 || std::memcmp(b, "HTTP/1.", 7) != 0 ||
+      (b[7] != '0' && b[7] != '1') || b[8] != ' ') {
+    return false;
+  }
+  for (auto i = 9; i < 12; i++) {
+    if (b[i] < '0' || '9' < b[i]) { return false; }
+  }
+
+  auto p = b + 12;
+  if (p != e) {
+    if (*p != ' ') { return false; }
+    p++;
+    for (auto q = p; q < e; q++) {
+      if (*q == '\r' || *q == '\n') { return false; }
+    }
+  }
+
+  version.assign(b, 8);
+  status = (b[9] - '0') * 100 + (b[10] - '0') * 10 + (b[11] - '0');
+  reason.assign(p, e);
+  return true;
+}
 
 class MultipartFormDataParser {
 public:
@@ -2141,14 +2194,10 @@ public:
           if (start_with_case_ignore(header, header_name)) {
             file_.content_type = trim_copy(header.substr(header_name.size()));
           } else {
-            static const std::regex re_content_disposition(
-                R"~(^Content-Disposition:\s*form-data;\s*(.*)$)~",
-                std::regex_constants::icase);
-
-            std::smatch m;
-            if (std::regex_match(header, m, re_content_disposition)) {
+            std::string disposition_params;
+            if (parse_content_disposition(header, disposition_params)) {
               Params params;
-              parse_disposition_params(m[1], params);
+              parse_disposition_params(disposition_params, params);
 
               auto it = params.find("name");
               if (it != params.end()) {
@@ -2164,12 +2213,13 @@ public:
               it = params.find("filename*");
               if (it != params.end()) {
                 // Only allow UTF-8 enconnding...
-                static const std::regex re_rfc5987_encoding(
-                    R"~(^UTF-8''(.+?)$)~", std::regex_constants::icase);
-
-                std::smatch m2;
-                if (std::regex_match(it->second, m2, re_rfc5987_encoding)) {
-                  file_.filename = decode_url(m2[1], false); // override...
+                static const std::string rfc5987_utf8 = "utf-8''";
+                const auto &value = it->second;
+                if (value.size() > rfc5987_utf8.size() &&
+                    start_with_case_ignore(value, rfc5987_utf8) &&
+                    value.find_first_of("\r\n") == std::string::npos) {
+                  file_.filename = decode_url(
+                      value.substr(rfc5987_utf8.size()), false); // override...
                 } else {
                   is_valid_ = false;
                   return false;
@@ -2239,6 +2289,34 @@ private:
     file_.content_type.clear();
   }
 
+  // "Content-Disposition: form-data; <params>" -> <params>
+  bool parse_content_disposition(const std::string &header,
+                                 std::string &params) const {
+    static const std::string header_name = "content-disposition:";
+    static const std::string form_data = "form-data;";
+    if (!start_with_case_ignore(header, header_name)) { return false; }
+
+    auto is_space = [](char c) {
+      return c == ' ' || ('\t' <= c && c <= '\r');
+    };
+    auto pos = header_name.size();
+    while (pos < header.size() && is_space(header[pos])) {
+      pos++;
+    }
+    if (!start_with_case_ignore(header.substr(pos), form_data)) {
+      return false;
+    }
+    pos += form_data.size();
+    while (pos < header.size() && is_space(header[pos])) {
+      pos++;
+    }
+    if (header.find_first_of("\r\n", pos) != std::string::npos) {
+      return false;
+    }
+    params = header.substr(pos);
+    return true;
+  }
+
   bool start_with_case_ignore(const std::string &a,
                               const std::string &b) const {
     if (a.size() < b.size()) { return false; }
@@ -2860,6 +2938,65 @@ private:
   ContentProviderWithoutLength content_provider_;
 };
 
+// Empties a string that is about to be reused, letting go of buffers that
+// grew past what an ordinary request needs
+void clear_for_reuse(std::string &s) {
+  if (s.capacity() > CPPHTTPLIB_RECV_BUFSIZ) {
+    std::string().swap(s);
+  } else {
+    s.clear();
+  }
+}
+
+// Puts req back in its default-constructed state, keeping the capacity of
+// its strings and containers for the next request on the connection
+void reset_request(Request &req) {
+  req.method.clear();
+  req.path.clear();
+  req.headers.clear();
+  clear_for_reuse(req.body);
+  req.remote_addr.clear();
+  req.remote_port = -1;
+  req.local_addr.clear();
+  req.local_port = -1;
+  req.version.clear();
+  req.target.clear();
+  req.params.clear();
+  req.files.clear();
+  req.ranges.clear();
+  req.matches = Match();
+  req.path_params.clear();
+  req.response_handler = nullptr;
+  req.content_receiver = nullptr;
+  req.progress = nullptr;
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+  req.ssl = nullptr;
+#endif
+  req.redirect_count_ = CPPHTTPLIB_REDIRECT_MAX_COUNT;
+  req.content_length_ = 0;
+  req.content_provider_ = nullptr;
+  req.is_chunked_content_provider_ = false;
+  req.authorization_count_ = 0;
+}
+
+// Same for res, releasing its content provider's resources as ~Response does
+void reset_response(Response &res) {
+  if (res.content_provider_resource_releaser_) {
+    res.content_provider_resource_releaser_(res.content_provider_success_);
+  }
+  res.version.clear();
+  res.status = -1;
+  res.reason.clear();
+  res.headers.clear();
+  clear_for_reuse(res.body);
+  res.location.clear();
+  res.content_length_ = 0;
+  res.content_provider_ = nullptr;
+  res.content_provider_resource_releaser_ = nullptr;
+  res.is_chunked_content_provider_ = false;
+  res.content_provider_success_ = false;
+}
+
 } // namespace detail
 
 std::string hosted_at(const std::string &hostname) {
@@ -2903,8 +3040,8 @@ void hosted_at(const std::string &hostname,
 std::string append_query_params(const std::string &path,
                                        const Params &params) {
   std::string path_with_query = path;
-  const static std::regex re("[^?]+\\?.*");
-  auto delm = std::regex_match(path, re) ? '&' : '?';
+  auto query_pos = path.find('?');
+  auto delm = query_pos != std::string::npos && query_pos > 0 ? '&' : '?';
   path_with_query += delm + detail::params_to_query_str(params);
   return path_with_query;
 }
@@ -3106,6 +3243,10 @@ ssize_t Stream::write(const std::string &s) {
   return write(s.data(), s.size());
 }
 
+ssize_t Stream::peek(const char *&) { return 0; }
+
+void Stream::skip(size_t) {}
+
 namespace detail {
 
 // Socket stream implementation
@@ -3116,7 +3257,7 @@ SocketStream::SocketStream(socket_t sock, time_t read_timeout_sec,
     : sock_(sock), read_timeout_sec_(read_timeout_sec),
       read_timeout_usec_(read_timeout_usec),
       write_timeout_sec_(write_timeout_sec),
-      write_timeout_usec_(write_timeout_usec), read_buff_(read_buff_size_, 0) {}
+      write_timeout_usec_(write_timeout_usec) {}
 
 SocketStream::~SocketStream() = default;
 
@@ -3198,6 +3339,26 @@ void SocketStream::get_local_ip_and_port(std::string &ip,
 
 socket_t SocketStream::socket() const { return sock_; }
 
+ssize_t SocketStream::peek(const char *&ptr) {
+  if (read_buff_off_ == read_buff_content_size_) {
+    if (!is_readable()) { return -1; }
+
+    auto n = read_socket(sock_, read_buff_.data(), read_buff_size_,
+                         CPPHTTPLIB_RECV_FLAGS);
+    if (n <= 0) { return -1; }
+
+    read_buff_off_ = 0;
+    read_buff_content_size_ = static_cast<size_t>(n);
+  }
+
+  ptr = read_buff_.data() + read_buff_off_;
+  return static_cast<ssize_t>(read_buff_content_size_ - read_buff_off_);
+}
+
+void SocketStream::skip(size_t size) {
+  read_buff_off_ += (std::min)(size, read_buff_content_size_ - read_buff_off_);
+}
+
 // Buffer stream implementation
 bool BufferStream::is_readable() const { return true; }
 
@@ -3316,11 +3477,154 @@ bool PathParamsMatcher::match(Request &request) const {
   return starting_pos >= request.path.length();
 }
 
+bool LiteralMatcher::match(Request &request) const {
+  request.path_params.clear();
+  if (request.path != pattern_) {
+    request.matches = std::smatch();
+    return false;
+  }
+  // only a regex can fill Request::matches, so hits pay for one
+  return std::regex_match(request.path, request.matches, regex_);
+}
+
+bool LiteralMatcher::is_literal(const std::string &pattern) {
+  return pattern.find_first_of(".[]{}()\\*+?|^$") == std::string::npos;
+}
+
 bool RegexMatcher::match(Request &request) const {
   request.path_params.clear();
   return std::regex_match(request.path, request.matches, regex_);
 }
 
+void RouteIndex::add(const std::string &pattern) {
+  auto index = count_++;
+
+  // Only patterns whose every ':' starts a path segment fit in the trie
+  auto is_path_params = pattern.find("/:") != std::string::npos;
+  auto fits = is_path_params || LiteralMatcher::is_literal(pattern);
+  for (auto pos = pattern.find(':'); fits && pos != std::string::npos;
+       pos = pattern.find(':', pos + 1)) {
+    if (!is_path_params || pos == 0 || pattern[pos - 1] != '/') {
+      fits = false;
+    }
+  }
+  if (!fits) {
+    fallback_.push_back(index);
+    return;
+  }
+
+  auto node = &root_;
+  size_t pos = 0;
+  for (;;) {
+    auto slash = pattern.find('/', pos);
+    auto seg_end = slash == std::string::npos ? pattern.size() : slash;
+
+    if (is_path_params && seg_end > pos && pattern[pos] == ':') {
+      if (!node->param) { node->param.reset(new Node()); }
+      node = node->param.get();
+      // PathParamsMatcher lets "/users/:id/" match "/users/1" as well
+      if (slash == pattern.size() - 1) { node->routes.push_back(index); }
+    } else {
+      node = &add_child(*node, pattern.substr(pos, seg_end - pos));
+    }
+
+    if (slash == std::string::npos) { break; }
+    pos = slash + 1;
+  }
+  node->routes.push_back(index);
+}
+
+// FNV-1a
+size_t RouteIndex::segment_hash(const char *s, size_t len) {
+  uint64_t h = 14695981039346656037ull;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ static_cast<unsigned char>(s[i])) * 1099511628211ull;
+  }
+  return static_cast<size_t>(h);
+}
+
+RouteIndex::Node &RouteIndex::add_child(Node &node,
+                                        const std::string &segment) {
+  auto hash = segment_hash(segment.data(), segment.size());
+  auto it = std::lower_bound(
+      node.children.begin(), node.children.end(), hash,
+      [](const Child &child, size_t h) { return child.hash < h; });
+  for (; it != node.children.end() && it->hash == hash; ++it) {
+    if (it->segment == segment) { return *it->node; }
+  }
+  Child child{hash, segment, std::unique_ptr<Node>(new Node())};
+  return *node.children.insert(it, std::move(child))->node;
+}
+
+const RouteIndex::Node *RouteIndex::find_child(const Node &node,
+                                               const char *segment,
+                                               size_t len) {
+  auto hash = segment_hash(segment, len);
+  auto it = std::lower_bound(
+      node.children.begin(), node.children.end(), hash,
+      [](const Child &child, size_t h) { return child.hash < h; });
+  for (; it != node.children.end() && it->hash == hash; ++it) {
+    if (it->segment.size() == len &&
+        it->segment.compare(0, len, segment, len) == 0) {
+      return it->node.get();
+    }
+  }
+  return nullptr;
+}
+
+void RouteIndex::find(const std::string &path,
+                      std::vector<size_t> &candidates) const {
+  candidates.clear();
+  collect(root_, path, 0, candidates);
+  // Both are in place; a route can be collected twice through the trailing
+  // '/' rule below
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+  if (fallback_.empty()) { return; }
+
+  // Merge in the fallback routes from the back, since std::inplace_merge
+  // allocates a temporary buffer. No route is in both lists.
+  auto i = candidates.size();
+  auto j = fallback_.size();
+  candidates.resize(i + j);
+  for (auto k = candidates.size(); j > 0;) {
+    if (i > 0 && candidates[i - 1] > fallback_[j - 1]) {
+      candidates[--k] = candidates[--i];
+    } else {
+      candidates[--k] = fallback_[--j];
+    }
+  }
+}
+
+// pos is where the next segment of path starts, or npos once they're all used
+void RouteIndex::collect(const Node &node, const std::string &path,
+                         size_t pos, std::vector<size_t> &candidates) const {
+  if (pos == std::string::npos) {
+    candidates.insert(candidates.end(), node.routes.begin(), node.routes.end());
+    return;
+  }
+
+  auto slash = path.find('/', pos);
+  auto seg_end = slash == std::string::npos ? path.size() : slash;
+  auto next = slash == std::string::npos ? std::string::npos : slash + 1;
+
+  auto visit = [&](const Node &child) {
+    collect(child, path, next, candidates);
+    // PathParamsMatcher lets "/users/:id" match "/users/1/" as well
+    if (next == path.size()) {
+      candidates.insert(candidates.end(), child.routes.begin(),
+                        child.routes.end());
+    }
+  };
+
+  if (!node.children.empty()) {
+    auto child = find_child(node, path.data() + pos, seg_end - pos);
+    if (child) { visit(*child); }
+  }
+  if (node.param) { visit(*node.param); }
+}
+
 } // namespace detail
 
 // HTTP server implementation
@@ -3338,65 +3642,77 @@ std::unique_ptr<detail::MatcherBase>
 Server::make_matcher(const std::string &pattern) {
   if (pattern.find("/:") != std::string::npos) {
     return detail::make_unique<detail::PathParamsMatcher>(pattern);
+  } else if (detail::LiteralMatcher::is_literal(pattern)) {
+    return detail::make_unique<detail::LiteralMatcher>(pattern);
   } else {
     return detail::make_unique<detail::RegexMatcher>(pattern);
   }
 }
 
 Server &Server::Get(const std::string &pattern, Handler handler) {
+  get_routes_.add(pattern);
   get_handlers_.emplace_back(make_matcher(pattern), std::move(handler));
   return *this;
 }
 
 Server &Server::Post(const std::string &pattern, Handler handler) {
+  post_routes_.add(pattern);
   post_handlers_.emplace_back(make_matcher(pattern), std::move(handler));
   return *this;
 }
 
 Server &Server::Post(const std::string &pattern,
                             HandlerWithContentReader handler) {
+  post_routes_for_content_reader_.add(pattern);
   post_handlers_for_content_reader_.emplace_back(make_matcher(pattern),
                                                  std::move(handler));
   return *this;
 }
 
 Server &Server::Put(const std::string &pattern, Handler handler) {
+  put_routes_.add(pattern);
   put_handlers_.emplace_back(make_matcher(pattern), std::move(handler));
   return *this;
 }
 
 Server &Server::Put(const std::string &pattern,
                            HandlerWithContentReader handler) {
+  put_routes_for_content_reader_.add(pattern);
   put_handlers_for_content_reader_.emplace_back(make_matcher(pattern),
                                                 std::move(handler));
   return *this;
 }
 
 Server &Server::Patch(const std::string &pattern, Handler handler) {
+  patch_routes_.add(pattern);
   patch_handlers_.emplace_back(make_matcher(pattern), std::move(handler));
   return *this;
 }
 
 Server &Server::Patch(const std::string &pattern,
                              HandlerWithContentReader handler) {
+  patch_routes_for_content_reader_.add(pattern);
   patch_handlers_for_content_reader_.emplace_back(make_matcher(pattern),
                                                   std::move(handler));
   return *this;
 }
 
 Server &Server::Delete(const std::string &pattern, Handler handler) {
+  delete_routes_.add(pattern);
   delete_handlers_.emplace_back(make_matcher(pattern), std::move(handler));
   return *this;
 }
 
 Server &Server::Delete(const std::string &pattern,
                               HandlerWithContentReader handler) {
+  delete_routes_for_content_reader_.add(pattern);
   delete_handlers_for_content_reader_.emplace_back(make_matcher(pattern),
                                                    std::move(handler));
   return *this;
 }
 
 Server &Server::Options(const std::string &pattern, Handler handler) {
+  options_routes_.add(pattern);
   options_handlers_.emplace_back(make_matcher(pattern), std::move(handler));
   return *this;
 }
@@ -3532,6 +3848,13 @@ Server &Server::set_write_timeout(time_t sec, time_t usec) {
   return *this;
 }
 
+#ifdef CPPHTTPLIB_USE_EPOLL
+Server &Server::set_epoll_reactor(bool on) {
+  epoll_reactor_ = on;
+  return *this;
+}
+#endif
+
 Server &Server::set_idle_interval(time_t sec, time_t usec) {
   idle_interval_sec_ = sec;
   idle_interval_usec_ = usec;
@@ -3583,16 +3906,19 @@ void Server::stop() {
 bool Server::parse_request_line(const char *s, Request &req) {
   auto len = strlen(s);
   if (len < 2 || s[len - 2] != '\r' || s[len - 1] != '\n') { return false; }
-  len -= 2;
+  return parse_request_line(s, s + len - 2, req);
+}
 
+bool Server::parse_request_line(const char *beg, const char *end,
+                                Request &req) {
   {
     size_t count = 0;
 
-    detail::split(s, s + len, ' ', [&](const char *b, const char *e) {
+    detail::split(beg, end, ' ', [&](const char *b, const char *e) {
       switch (count) {
-      case 0: req.method = std::string(b, e); break;
-      case 1: req.target = std::string(b, e); break;
-      case 2: req.version = std::string(b, e); break;
+      case 0: req.method.assign(b, e); break;
+      case 1: req.target.assign(b, e); break;
+      case 2: req.version.assign(b, e); break;
       default: break;
       }
       count++;
@@ -3643,6 +3969,73 @@ bool Server::parse_request_line(const char *s, Request &req) {
   return true;
 }
 
+#ifdef CPPHTTPLIB_ZERO_COPY_PARSING
+bool Server::parse_buffered_request_head(Stream &strm, Request &req) {
+  const char *buf = nullptr;
+  auto n = strm.peek(buf);
+  if (n <= 0) { return false; }
+
+  auto p = buf;
+  auto end = buf + n;
+
+  // Request line. Lines the line reader treats specially (too long, NUL bytes
+  // that would cut it short) are left to it.
+  auto nl = static_cast<const char *>(memchr(p, '\n', n));
+  if (!nl || nl == p || nl[-1] != '\r') { return false; }
+  auto line_beg = p;
+  auto line_end = nl - 1;
+  if (static_cast<size_t>(nl + 1 - p) > CPPHTTPLIB_REQUEST_URI_MAX_LENGTH ||
+      memchr(line_beg, '\0', static_cast<size_t>(line_end - line_beg))) {
+    return false;
+  }
+  p = nl + 1;
+
+  // Header fields, parsed in place up to the blank line
+  for (;;) {
+    nl = static_cast<const char *>(
+        memchr(p, '\n', static_cast<size_t>(end - p)));
+    if (!nl) { break; }
+
+    auto size = static_cast<size_t>(nl + 1 - p);
+    auto line_terminator_len = 2;
+    if (size >= 2 && nl[-1] == '\r') {
+      if (size == 2) {
+        if (!parse_request_line(line_beg, line_end, req)) { break; }
+        strm.skip(static_cast<size_t>(nl + 1 - buf));
+        return true;
+      }
+#ifdef CPPHTTPLIB_ALLOW_LF_AS_LINE_TERMINATOR
+    } else {
+      if (size == 1) {
+        if (!parse_request_line(line_beg, line_end, req)) { break; }
+        strm.skip(static_cast<size_t>(nl + 1 - buf));
+        return true;
+      }
+      line_terminator_len = 1;
+    }
+#else
+    } else {
+      p = nl + 1;
+      continue; // Skip invalid line.
+    }
+#endif
+
+    if (size > CPPHTTPLIB_HEADER_MAX_LENGTH) { break; }
+
+    detail::parse_header(p, nl + 1 - line_terminator_len,
+                         [&](std::string &&key, std::string &&val) {
+                           req.headers.emplace(std::move(key), std::move(val));
+                         });
+    p = nl + 1;
+  }
+
+  // The head isn't complete in the buffer or needs the checks of the regular
+  // path; nothing has been consumed, so process_request starts over.
+  detail::reset_request(req);
+  return false;
+}
+#endif
+
 bool Server::write_response(Stream &strm, bool close_connection,
                                    const Request &req, Response &res) {
   return write_response_core(strm, close_connection, req, res, false);
@@ -3673,10 +4066,11 @@ bool Server::write_response_core(Stream &strm, bool close_connection,
   if (close_connection || req.get_header_value("Connection") == "close") {
     res.set_header("Connection", "close");
   } else {
-    std::stringstream ss;
-    ss << "timeout=" << keep_alive_timeout_sec_
-       << ", max=" << keep_alive_max_count_;
-    res.set_header("Keep-Alive", ss.str());
+    char buf[64];
+    snprintf(buf, sizeof(buf), "timeout=%lld, max=%llu",
+             static_cast<long long>(keep_alive_timeout_sec_),
+             static_cast<unsigned long long>(keep_alive_max_count_));
+    res.set_header("Keep-Alive", buf);
   }
 
   if (!res.has_header("Content-Type") &&
@@ -3975,6 +4369,12 @@ bool Server::listen_internal() {
   {
     std::unique_ptr<TaskQueue> task_queue(new_task_queue());
 
+#ifdef CPPHTTPLIB_USE_EPOLL
+    if (epoll_reactor_ && supports_epoll_reactor()) {
+      return listen_epoll(*task_queue);
+    }
+#endif
+
     while (svr_sock_ != INVALID_SOCKET) {
 #ifndef _WIN32
       if (idle_interval_sec_ > 0 || idle_interval_usec_ > 0) {
@@ -4008,45 +4408,223 @@ bool Server::listen_internal() {
         break;
       }
 
-      {
+      set_socket_timeouts(sock);
+
+      task_queue->enqueue([this, sock]() { process_and_close_socket(sock); });
+    }
+
+    task_queue->shutdown();
+  }
+
+  return ret;
+}
+
+void Server::set_socket_timeouts(socket_t sock) const {
+  {
 #ifdef _WIN32
-        auto timeout = static_cast<uint32_t>(read_timeout_sec_ * 1000 +
-                                             read_timeout_usec_ / 1000);
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO,
-                   reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+    auto timeout = static_cast<uint32_t>(read_timeout_sec_ * 1000 +
+                                         read_timeout_usec_ / 1000);
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO,
+               reinterpret_cast<const char *>(&timeout), sizeof(timeout));
 #else
-        timeval tv;
-        tv.tv_sec = static_cast<long>(read_timeout_sec_);
-        tv.tv_usec = static_cast<decltype(tv.tv_usec)>(read_timeout_usec_);
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO,
-                   reinterpret_cast<const void *>(&tv), sizeof(tv));
+    timeval tv;
+    tv.tv_sec = static_cast<long>(read_timeout_sec_);
+    tv.tv_usec = static_cast<decltype(tv.tv_usec)>(read_timeout_usec_);
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO,
+               reinterpret_cast<const void *>(&tv), sizeof(tv));
 #endif
-      }
-      {
-
+  }
+  {
 #ifdef _WIN32
-        auto timeout = static_cast<uint32_t>(write_timeout_sec_ * 1000 +
-                                             write_timeout_usec_ / 1000);
-        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO,
-                   reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+    auto timeout = static_cast<uint32_t>(write_timeout_sec_ * 1000 +
+                                         write_timeout_usec_ / 1000);
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO,
+               reinterpret_cast<const char *>(&timeout), sizeof(timeout));
 #else
-        timeval tv;
-        tv.tv_sec = static_cast<long>(write_timeout_sec_);
-        tv.tv_usec = static_cast<decltype(tv.tv_usec)>(write_timeout_usec_);
-        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO,
-                   reinterpret_cast<const void *>(&tv), sizeof(tv));
+    timeval tv;
+    tv.tv_sec = static_cast<long>(write_timeout_sec_);
+    tv.tv_usec = static_cast<decltype(tv.tv_usec)>(write_timeout_usec_);
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO,
+               reinterpret_cast<const void *>(&tv), sizeof(tv));
 #endif
+  }
+}
+
+#ifdef CPPHTTPLIB_USE_EPOLL
+bool Server::supports_epoll_reactor() const { return true; }
+
+// Connections are registered with EPOLLONESHOT, so a readable connection is
+// handed to exactly one worker, which processes one request and then re-arms
+// it (or closes it). Idle connections only cost an fd and an
+// epoll_connections_ entry.
+bool Server::listen_epoll(TaskQueue &task_queue) {
+  auto listen_sock = svr_sock_.load();
+
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = listen_sock;
+  if (epoll_fd_ < 0 ||
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_sock, &ev) < 0) {
+    if (epoll_fd_ >= 0) { ::close(epoll_fd_); }
+    epoll_fd_ = -1;
+    task_queue.shutdown();
+    return false;
+  }
+
+  auto ret = true;
+  auto has_idle_interval = idle_interval_sec_ > 0 || idle_interval_usec_ > 0;
+  // stop() closes the server socket, which silently drops it from the epoll
+  // set, so wake up regularly to notice (and to time out idle connections)
+  auto wait_msec = 100;
+  if (has_idle_interval) {
+    wait_msec = std::min(wait_msec, static_cast<int>(idle_interval_sec_ * 1000 +
+                                                     idle_interval_usec_ / 1000));
+  }
+  std::vector<epoll_event> events(256);
+
+  while (ret && svr_sock_ != INVALID_SOCKET) {
+    auto n = epoll_wait(epoll_fd_, events.data(),
+                        static_cast<int>(events.size()), wait_msec);
+    if (n < 0) {
+      if (errno == EINTR) { continue; }
+      ret = false;
+      break;
+    }
+    if (n == 0 && has_idle_interval) { task_queue.on_idle(); }
+
+    for (int i = 0; ret && i < n && svr_sock_ != INVALID_SOCKET; i++) {
+      auto sock = events[i].data.fd;
+
+      if (sock == listen_sock) {
+        socket_t client = accept(listen_sock, nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+          if (errno == EMFILE) {
+            // The per-process limit of open file descriptors has been reached.
+            // Try to accept new connections after a short sleep.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+          } else if (errno == EINTR || errno == EAGAIN) {
+            continue;
+          }
+          if (svr_sock_ != INVALID_SOCKET) {
+            detail::close_socket(svr_sock_);
+            ret = false;
+          }
+          continue;
+        }
+
+        set_socket_timeouts(client);
+
+        std::lock_guard<std::mutex> guard(epoll_mutex_);
+        epoll_event client_ev{};
+        client_ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        client_ev.data.fd = client;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client, &client_ev) < 0) {
+          detail::close_socket(client);
+          continue;
+        }
+        epoll_connections_[client] = {keep_alive_max_count_, false,
+                                      std::chrono::steady_clock::now()};
+        continue;
       }
 
-      task_queue->enqueue([this, sock]() { process_and_close_socket(sock); });
+      if (!(events[i].events & EPOLLIN)) {
+        // EPOLLHUP or EPOLLERR without anything left to read
+        close_epoll_connection(sock);
+        continue;
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(epoll_mutex_);
+        auto it = epoll_connections_.find(sock);
+        if (it == epoll_connections_.end()) { continue; }
+        it->second.busy = true;
+      }
+      task_queue.enqueue([this, sock]() { process_epoll_request(sock); });
     }
 
-    task_queue->shutdown();
+    close_idle_epoll_connections();
   }
 
+  // Let in-flight requests finish, then drop the idle connections
+  task_queue.shutdown();
+  {
+    std::lock_guard<std::mutex> guard(epoll_mutex_);
+    for (auto &x : epoll_connections_) {
+      detail::shutdown_socket(x.first);
+      detail::close_socket(x.first);
+    }
+    epoll_connections_.clear();
+  }
+  ::close(epoll_fd_);
+  epoll_fd_ = -1;
+
   return ret;
 }
 
+void Server::process_epoll_request(socket_t sock) {
+  size_t remaining;
+  {
+    std::lock_guard<std::mutex> guard(epoll_mutex_);
+    remaining = epoll_connections_[sock].remaining;
+  }
+
+  auto close_connection = remaining <= 1 || svr_sock_ == INVALID_SOCKET;
+  auto connection_closed = false;
+  bool ret;
+  {
+    detail::SocketStream strm(sock, read_timeout_sec_, read_timeout_usec_,
+                              write_timeout_sec_, write_timeout_usec_);
+    ret = process_request(strm, close_connection, connection_closed, nullptr);
+  }
+
+  if (!ret || connection_closed || close_connection) {
+    close_epoll_connection(sock);
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(epoll_mutex_);
+  auto &conn = epoll_connections_[sock];
+  conn.remaining--;
+  conn.busy = false;
+  conn.idle_since = std::chrono::steady_clock::now();
+
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  ev.data.fd = sock;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, sock, &ev) < 0) {
+    epoll_connections_.erase(sock);
+    detail::shutdown_socket(sock);
+    detail::close_socket(sock);
+  }
+}
+
+void Server::close_epoll_connection(socket_t sock) {
+  std::lock_guard<std::mutex> guard(epoll_mutex_);
+  if (epoll_connections_.erase(sock)) {
+    detail::shutdown_socket(sock);
+    detail::close_socket(sock); // also removes it from the epoll set
+  }
+}
+
+void Server::close_idle_epoll_connections() {
+  auto now = std::chrono::steady_clock::now();
+  auto timeout = std::chrono::seconds(keep_alive_timeout_sec_);
+
+  std::lock_guard<std::mutex> guard(epoll_mutex_);
+  for (auto it = epoll_connections_.begin(); it != epoll_connections_.end();) {
+    if (!it->second.busy && now - it->second.idle_since > timeout) {
+      detail::shutdown_socket(it->first);
+      detail::close_socket(it->first);
+      it = epoll_connections_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+#endif
+
 bool Server::routing(Request &req, Response &res, Stream &strm) {
   if (pre_routing_handler_ &&
       pre_routing_handler_(req, res) == HandlerResponse::Handled) {
@@ -4077,25 +4655,29 @@ bool Server::routing(Request &req, Response &res, Stream &strm) {
       if (req.method == "POST") {
         if (dispatch_request_for_content_reader(
                 req, res, std::move(reader),
-                post_handlers_for_content_reader_)) {
+                post_handlers_for_content_reader_,
+                post_routes_for_content_reader_)) {
           return true;
         }
       } else if (req.method == "PUT") {
         if (dispatch_request_for_content_reader(
                 req, res, std::move(reader),
-                put_handlers_for_content_reader_)) {
+                put_handlers_for_content_reader_,
+                put_routes_for_content_reader_)) {
           return true;
         }
       } else if (req.method == "PATCH") {
         if (dispatch_request_for_content_reader(
                 req, res, std::move(reader),
-                patch_handlers_for_content_reader_)) {
+                patch_handlers_for_content_reader_,
+                patch_routes_for_content_reader_)) {
           return true;
         }
       } else if (req.method == "DELETE") {
         if (dispatch_request_for_content_reader(
                 req, res, std::move(reader),
-                delete_handlers_for_content_reader_)) {
+                delete_handlers_for_content_reader_,
+                delete_routes_for_content_reader_)) {
           return true;
         }
       }
@@ -4107,35 +4689,44 @@ bool Server::routing(Request &req, Response &res, Stream &strm) {
 
   // Regular handler
   if (req.method == "GET" || req.method == "HEAD") {
-    return dispatch_request(req, res, get_handlers_);
+    return dispatch_request(req, res, get_handlers_, get_routes_);
   } else if (req.method == "POST") {
-    return dispatch_request(req, res, post_handlers_);
+    return dispatch_request(req, res, post_handlers_, post_routes_);
   } else if (req.method == "PUT") {
-    return dispatch_request(req, res, put_handlers_);
+    return dispatch_request(req, res, put_handlers_, put_routes_);
   } else if (req.method == "DELETE") {
-    return dispatch_request(req, res, delete_handlers_);
+    return dispatch_request(req, res, delete_handlers_, delete_routes_);
   } else if (req.method == "OPTIONS") {
-    return dispatch_request(req, res, options_handlers_);
+    return dispatch_request(req, res, options_handlers_, options_routes_);
   } else if (req.method == "PATCH") {
-    return dispatch_request(req, res, patch_handlers_);
+    return dispatch_request(req, res, patch_handlers_, patch_routes_);
   }
 
   res.status = 400;
   return false;
 }
 
-bool Server::dispatch_request(Request &req, Response &res,
-                                     const Handlers &handlers) {
-  for (const auto &x : handlers) {
-    const auto &matcher = x.first;
-    const auto &handler = x.second;
-
-    if (matcher->match(req)) {
-      handler(req, res);
-      return true;
-    }
+// The first of handlers whose matcher matches req (which fills in its matches
+// and path_params), or handlers.size() if none does. The candidates buffer is
+// per thread and reused, and it's done with before any handler runs.
+template <typename T>
+size_t Server::find_route(Request &req, const T &handlers,
+                          const detail::RouteIndex &routes) const {
+  static thread_local std::vector<size_t> candidates;
+  routes.find(req.path, candidates);
+  for (auto i : candidates) {
+    if (handlers[i].first->match(req)) { return i; }
   }
-  return false;
+  return handlers.size();
+}
+
+bool Server::dispatch_request(Request &req, Response &res,
+                                     const Handlers &handlers,
+                                     const detail::RouteIndex &routes) {
+  auto i = find_route(req, handlers, routes);
+  if (i == handlers.size()) { return false; }
+  handlers[i].second(req, res);
+  return true;
 }
 
 void Server::apply_ranges(const Request &req, Response &res,
@@ -4252,33 +4843,44 @@ void Server::apply_ranges(const Request &req, Response &res,
 
 bool Server::dispatch_request_for_content_reader(
     Request &req, Response &res, ContentReader content_reader,
-    const HandlersForContentReader &handlers) {
-  for (const auto &x : handlers) {
-    const auto &matcher = x.first;
-    const auto &handler = x.second;
-
-    if (matcher->match(req)) {
-      handler(req, res, content_reader);
-      return true;
-    }
-  }
-  return false;
+    const HandlersForContentReader &handlers,
+    const detail::RouteIndex &routes) {
+  auto i = find_route(req, handlers, routes);
+  if (i == handlers.size()) { return false; }
+  handlers[i].second(req, res, content_reader);
+  return true;
 }
 
 bool
 Server::process_request(Stream &strm, bool close_connection,
                         bool &connection_closed,
                         const std::function<void(Request &)> &setup_request) {
+  Request req;
+  Response res;
+  return process_request(strm, req, res, close_connection, connection_closed,
+                         setup_request);
+}
+
+bool
+Server::process_request(Stream &strm, Request &req, Response &res,
+                        bool close_connection, bool &connection_closed,
+                        const std::function<void(Request &)> &setup_request) {
   std::array<char, 2048> buf{};
 
   detail::stream_line_reader line_reader(strm, buf.data(), buf.size());
 
-  // Connection has been closed on client
-  if (!line_reader.getline()) { return false; }
+  // With CPPHTTPLIB_ZERO_COPY_PARSING the head is parsed straight out of the
+  // stream's receive buffer when it arrived in one piece
+  auto head_parsed = false;
+#ifdef CPPHTTPLIB_ZERO_COPY_PARSING
+  const char *head = nullptr;
+  if (strm.peek(head) < 0) { return false; }
+  head_parsed = parse_buffered_request_head(strm, req);
+#endif
 
-  Request req;
+  // Connection has been closed on client
+  if (!head_parsed && !line_reader.getline()) { return false; }
 
-  Response res;
   res.version = "HTTP/1.1";
   res.headers = default_headers_;
 
@@ -4289,7 +4891,7 @@ Server::process_request(Stream &strm, bool close_connection,
   // Socket file descriptor exceeded FD_SETSIZE...
   if (strm.socket() >= FD_SETSIZE) {
     Headers dummy;
-    detail::read_headers(strm, dummy);
+    if (!head_parsed) { detail::read_headers(strm, dummy); }
     res.status = 500;
     return write_response(strm, close_connection, req, res);
   }
@@ -4297,7 +4899,8 @@ Server::process_request(Stream &strm, bool close_connection,
 #endif
 
   // Check if the request URI doesn't exceed the limit
-  if (line_reader.size() > CPPHTTPLIB_REQUEST_URI_MAX_LENGTH) {
+  if (!head_parsed &&
+      line_reader.size() > CPPHTTPLIB_REQUEST_URI_MAX_LENGTH) {
     Headers dummy;
     detail::read_headers(strm, dummy);
     res.status = 414;
@@ -4305,8 +4908,8 @@ Server::process_request(Stream &strm, bool close_connection,
   }
 
   // Request line and headers
-  if (!parse_request_line(line_reader.ptr(), req) ||
-      !detail::read_headers(strm, req.headers)) {
+  if (!head_parsed && (!parse_request_line(line_reader.ptr(), req) ||
+                       !detail::read_headers(strm, req.headers))) {
     res.status = 400;
     return write_response(strm, close_connection, req, res);
   }
@@ -4402,13 +5005,27 @@ Server::process_request(Stream &strm, bool close_connection,
 bool Server::is_valid() const { return true; }
 
 bool Server::process_and_close_socket(socket_t sock) {
+#ifdef CPPHTTPLIB_REUSE_REQUEST_STORAGE
+  // One Request and Response for every request on the connection
+  Request req;
+  Response res;
+#endif
+
   auto ret = detail::process_server_socket(
       svr_sock_, sock, keep_alive_max_count_, keep_alive_timeout_sec_,
       read_timeout_sec_, read_timeout_usec_, write_timeout_sec_,
       write_timeout_usec_,
-      [this](Stream &strm, bool close_connection, bool &connection_closed) {
+      [&](Stream &strm, bool close_connection, bool &connection_closed) {
+#ifdef CPPHTTPLIB_REUSE_REQUEST_STORAGE
+        auto ret = process_request(strm, req, res, close_connection,
+                                   connection_closed, nullptr);
+        detail::reset_request(req);
+        detail::reset_response(res);
+        return ret;
+#else
         return process_request(strm, close_connection, connection_closed,
                                nullptr);
+#endif
       });
 
   detail::shutdown_socket(sock);
@@ -4508,6 +5125,7 @@ bool ClientImpl::create_and_connect_socket(Socket &socket,
   auto sock = create_client_socket(error);
   if (sock == INVALID_SOCKET) { return false; }
   socket.sock = sock;
+  connection_count_++;
   return true;
 }
 
@@ -4551,29 +5169,22 @@ bool ClientImpl::read_response_line(Stream &strm, const Request &req,
 
   if (!line_reader.getline()) { return false; }
 
-#ifdef CPPHTTPLIB_ALLOW_LF_AS_LINE_TERMINATOR
-  const static std::regex re("(HTTP/1\\.[01]) (\\d{3})(?: (.*?))?\r?\n");
-#else
-  const static std::regex re("(HTTP/1\\.[01]) (\\d{3})(?: (.*?))?\r\n");
-#endif
-
-  std::cmatch m;
-  if (!std::regex_match(line_reader.ptr(), m, re)) {
+  if (!detail::parse_status_line(line_reader.ptr(),
+                                 line_reader.ptr() + line_reader.size(),
+                                 res.version, res.status, res.reason)) {
     return req.method == "CONNECT";
   }
-  res.version = std::string(m[1]);
-  res.status = std::stoi(std::string(m[2]));
-  res.reason = std::string(m[3]);
 
   // Ignore '100 Continue'
   while (res.status == 100) {
     if (!line_reader.getline()) { return false; } // CRLF
     if (!line_reader.getline()) { return false; } // next response line
 
-    if (!std::regex_match(line_reader.ptr(), m, re)) { return false; }
-    res.version = std::string(m[1]);
-    res.status = std::stoi(std::string(m[2]));
-    res.reason = std::string(m[3]);
+    if (!detail::parse_status_line(line_reader.ptr(),
+                                   line_reader.ptr() + line_reader.size(),
+                                   res.version, res.status, res.reason)) {
+      return false;
+    }
   }
 
   return true;
@@ -5706,6 +6317,8 @@ size_t ClientImpl::is_socket_open() const {
 
 socket_t ClientImpl::socket() const { return socket_.sock; }
 
+size_t ClientImpl::connection_count() const { return connection_count_; }
+
 void ClientImpl::set_connection_timeout(time_t sec, time_t usec) {
   connection_timeout_sec_ = sec;
   connection_timeout_usec_ = usec;
@@ -6131,6 +6744,12 @@ SSLServer::~SSLServer() {
 
 bool SSLServer::is_valid() const { return ctx_; }
 
+#ifdef CPPHTTPLIB_USE_EPOLL
+// TLS sessions live in process_and_close_socket, so keep one thread per
+// connection
+bool SSLServer::supports_epoll_reactor() const { return false; }
+#endif
+
 SSL_CTX *SSLServer::ssl_context() const { return ctx_; }
 
 bool SSLServer::process_and_close_socket(socket_t sock) {
@@ -6144,14 +6763,27 @@ bool SSLServer::process_and_close_socket(socket_t sock) {
 
   auto ret = false;
   if (ssl) {
+#ifdef CPPHTTPLIB_REUSE_REQUEST_STORAGE
+    Request req;
+    Response res;
+#endif
+
     ret = detail::process_server_socket_ssl(
         svr_sock_, ssl, sock, keep_alive_max_count_, keep_alive_timeout_sec_,
         read_timeout_sec_, read_timeout_usec_, write_timeout_sec_,
         write_timeout_usec_,
-        [this, ssl](Stream &strm, bool close_connection,
-                    bool &connection_closed) {
+        [&](Stream &strm, bool close_connection, bool &connection_closed) {
+#ifdef CPPHTTPLIB_REUSE_REQUEST_STORAGE
+          auto ret = process_request(
+              strm, req, res, close_connection, connection_closed,
+              [&](Request &req2) { req2.ssl = ssl; });
+          detail::reset_request(req);
+          detail::reset_response(res);
+          return ret;
+#else
           return process_request(strm, close_connection, connection_closed,
                                  [&](Request &req) { req.ssl = ssl; });
+#endif
         });
 
     // Shutdown gracefully if the result seemed successful, non-gracefully if
@@ -6178,6 +6810,14 @@ SSLClient::SSLClient(const std::string &host, int port,
     : ClientImpl(host, port, client_cert_path, client_key_path) {
   ctx_ = SSL_CTX_new(TLS_client_method());
 
+  if (ctx_) {
+    // Keep the newest session ourselves so reconnects can resume it
+    SSL_CTX_set_app_data(ctx_, this);
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT |
+                                             SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx_, new_session_callback);
+  }
+
   detail::split(&host_[0], &host_[host_.size()], '.',
                 [&](const char *b, const char *e) {
                   host_components_.emplace_back(b, e);
@@ -6199,6 +6839,14 @@ SSLClient::SSLClient(const std::string &host, int port,
     : ClientImpl(host, port) {
   ctx_ = SSL_CTX_new(TLS_client_method());
 
+  if (ctx_) {
+    // Keep the newest session ourselves so reconnects can resume it
+    SSL_CTX_set_app_data(ctx_, this);
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT |
+                                             SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx_, new_session_callback);
+  }
+
   detail::split(&host_[0], &host_[host_.size()], '.',
                 [&](const char *b, const char *e) {
                   host_components_.emplace_back(b, e);
@@ -6219,6 +6867,7 @@ SSLClient::~SSLClient() {
   // base function rather than the derived function once we get to the
   // base class destructor, and won't free the SSL (causing a leak).
   shutdown_ssl_impl(socket_, true);
+  if (session_) { SSL_SESSION_free(session_); }
 }
 
 bool SSLClient::is_valid() const { return ctx_; }
@@ -6247,6 +6896,21 @@ long SSLClient::get_openssl_verify_result() const {
 
 SSL_CTX *SSLClient::ssl_context() const { return ctx_; }
 
+size_t SSLClient::tls_session_resumed_count() const {
+  return tls_session_resumed_count_;
+}
+
+int SSLClient::new_session_callback(SSL *ssl, SSL_SESSION *session) {
+  auto cli = static_cast<SSLClient *>(
+      SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+  if (!cli) { return 0; }
+
+  std::lock_guard<std::mutex> guard(cli->session_mutex_);
+  if (cli->session_) { SSL_SESSION_free(cli->session_); }
+  cli->session_ = session;
+  return 1; // We took ownership of the session
+}
+
 bool SSLClient::create_and_connect_socket(Socket &socket, Error &error) {
   return is_valid() && ClientImpl::create_and_connect_socket(socket, error);
 }
@@ -6364,6 +7028,11 @@ bool SSLClient::initialize_ssl(Socket &socket, Error &error) {
           SSL_set_verify(ssl2, SSL_VERIFY_NONE, nullptr);
         }
 
+        {
+          std::lock_guard<std::mutex> guard(session_mutex_);
+          if (session_) { SSL_set_session(ssl2, session_); }
+        }
+
         if (!detail::ssl_connect_or_accept_nonblocking(
                 socket.sock, ssl2, SSL_connect, connection_timeout_sec_,
                 connection_timeout_usec_)) {
@@ -6371,6 +7040,8 @@ bool SSLClient::initialize_ssl(Socket &socket, Error &error) {
           return false;
         }
 
+        if (SSL_session_reused(ssl2)) { tls_session_resumed_count_++; }
+
         if (server_certificate_verification_) {
           verify_result_ = SSL_get_verify_result(ssl2);
 
@@ -6942,6 +7613,8 @@ int Client::port() const { return cli_->port(); }
 
 size_t Client::is_socket_open() const { return cli_->is_socket_open(); }
 
+size_t Client::connection_count() const { return cli_->connection_count(); }
+
 socket_t Client::socket() const { return cli_->socket(); }
 
 void
@@ -7065,6 +7738,13 @@ SSL_CTX *Client::ssl_context() const {
   if (is_ssl_) { return static_cast<SSLClient &>(*cli_).ssl_context(); }
   return nullptr;
 }
+
+size_t Client::tls_session_resumed_count() const {
+  if (is_ssl_) {
+    return static_cast<SSLClient &>(*cli_).tls_session_resumed_count();
+  }
+  return 0;
+}
 #endif
 
 } // namespace httplib
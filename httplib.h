@@ -120,6 +120,12 @@
 #define CPPHTTPLIB_LISTEN_BACKLOG 5
 #endif
 
+// The epoll reactor is meant for many open connections, and select() can't
+// wait on fds past FD_SETSIZE
+#if defined(CPPHTTPLIB_USE_EPOLL) && !defined(CPPHTTPLIB_USE_POLL)
+#define CPPHTTPLIB_USE_POLL
+#endif
+
 /*
  * Headers
  */
@@ -198,6 +204,12 @@ using socket_t = SOCKET;
 #ifdef CPPHTTPLIB_USE_POLL
 #include <poll.h>
 #endif
+#ifdef CPPHTTPLIB_USE_EPOLL
+#ifndef __linux__
+#error "CPPHTTPLIB_USE_EPOLL is only supported on Linux"
+#endif
+#include <sys/epoll.h>
+#endif
 #include <csignal>
 #include <pthread.h>
 #include <sys/mman.h>
@@ -360,7 +372,269 @@ private:
 
 } // namespace detail
 
+#ifndef CPPHTTPLIB_FLAT_HEADERS_INLINE_COUNT
+#define CPPHTTPLIB_FLAT_HEADERS_INLINE_COUNT 8
+#endif
+
+/*
+ * A drop-in replacement for the std::multimap Headers (selected with
+ * CPPHTTPLIB_FLAT_HEADERS) that keeps the fields in one contiguous array,
+ * stored inline until there are more than
+ * CPPHTTPLIB_FLAT_HEADERS_INLINE_COUNT of them, so adding a field doesn't
+ * allocate a tree node. Each field keeps the hash of its lowercased name,
+ * so a lookup only does the case-insensitive compare on a hash match.
+ *
+ * Fields with the same name are kept next to each other, in insertion order,
+ * so equal_range() works like the multimap's. Otherwise fields iterate in
+ * insertion order rather than sorted by name.
+ */
+class FlatHeaders {
+public:
+  using key_type = std::string;
+  using mapped_type = std::string;
+  using value_type = std::pair<std::string, std::string>;
+  using size_type = size_t;
+  using iterator = value_type *;
+  using const_iterator = const value_type *;
+
+  FlatHeaders() = default;
+
+  FlatHeaders(std::initializer_list<value_type> fields) {
+    insert(fields.begin(), fields.end());
+  }
+
+  FlatHeaders(const FlatHeaders &rhs) { insert(rhs.begin(), rhs.end()); }
+
+  FlatHeaders(FlatHeaders &&rhs) noexcept { take(rhs); }
+
+  FlatHeaders &operator=(const FlatHeaders &rhs) {
+    if (this != &rhs) {
+      clear();
+      insert(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  FlatHeaders &operator=(FlatHeaders &&rhs) noexcept {
+    if (this != &rhs) {
+      clear();
+      release();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  ~FlatHeaders() {
+    clear();
+    release();
+  }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + size_; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size_; }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void clear() {
+    for (size_t i = 0; i < size_; i++) {
+      data()[i].~value_type();
+    }
+    size_ = 0;
+  }
+
+  iterator find(const std::string &key) {
+    return data() + index_of(key, hash(key));
+  }
+  const_iterator find(const std::string &key) const {
+    return data() + index_of(key, hash(key));
+  }
+
+  size_type count(const std::string &key) const {
+    auto r = equal_range(key);
+    return static_cast<size_type>(r.second - r.first);
+  }
+
+  std::pair<iterator, iterator> equal_range(const std::string &key) {
+    auto h = hash(key);
+    auto first = index_of(key, h);
+    return std::make_pair(data() + first, data() + group_end(first, key, h));
+  }
+  std::pair<const_iterator, const_iterator>
+  equal_range(const std::string &key) const {
+    auto h = hash(key);
+    auto first = index_of(key, h);
+    return std::make_pair(data() + first, data() + group_end(first, key, h));
+  }
+
+  template <typename K, typename V> iterator emplace(K &&key, V &&val) {
+    return insert(value_type(std::forward<K>(key), std::forward<V>(val)));
+  }
+
+  iterator insert(const value_type &field) { return insert(value_type(field)); }
+
+  iterator insert(value_type &&field) {
+    auto h = hash(field.first);
+    auto first = index_of(field.first, h);
+    auto pos = first == size_ ? size_ : group_end(first, field.first, h);
+
+    if (size_ == capacity_) { grow(); }
+    new (data() + size_) value_type(std::move(field));
+    hashes()[size_] = h;
+    size_++;
+
+    // Move it back next to the other fields with the same name
+    std::rotate(data() + pos, data() + size_ - 1, data() + size_);
+    std::rotate(hashes() + pos, hashes() + size_ - 1, hashes() + size_);
+    return data() + pos;
+  }
+
+  template <typename InputIt> void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      insert(value_type(first->first, first->second));
+    }
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    auto b = static_cast<size_t>(first - data());
+    auto e = static_cast<size_t>(last - data());
+    std::move(data() + e, data() + size_, data() + b);
+    std::move(hashes() + e, hashes() + size_, hashes() + b);
+    for (auto i = size_ - (e - b); i < size_; i++) {
+      data()[i].~value_type();
+    }
+    size_ -= e - b;
+    return data() + b;
+  }
+
+  size_type erase(const std::string &key) {
+    auto r = equal_range(key);
+    auto n = static_cast<size_type>(r.second - r.first);
+    erase(r.first, r.second);
+    return n;
+  }
+
+private:
+  static const size_t inline_count_ = CPPHTTPLIB_FLAT_HEADERS_INLINE_COUNT;
+
+  // FNV-1a over the lowercased name
+  static uint32_t hash(const std::string &key) {
+    uint32_t h = 2166136261u;
+    for (auto c : key) {
+      h ^= static_cast<uint32_t>(::tolower(static_cast<unsigned char>(c)));
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  static bool equal_ci(const std::string &a, const std::string &b) {
+    if (a.size() != b.size()) { return false; }
+    for (size_t i = 0; i < a.size(); i++) {
+      if (::tolower(static_cast<unsigned char>(a[i])) !=
+          ::tolower(static_cast<unsigned char>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool matches(size_t i, const std::string &key, uint32_t h) const {
+    return hashes()[i] == h && equal_ci(data()[i].first, key);
+  }
+
+  // Index of the first field named key, or size_ if there is none
+  size_t index_of(const std::string &key, uint32_t h) const {
+    for (size_t i = 0; i < size_; i++) {
+      if (matches(i, key, h)) { return i; }
+    }
+    return size_;
+  }
+
+  // One past the last of the adjacent fields named key starting at first
+  size_t group_end(size_t first, const std::string &key, uint32_t h) const {
+    auto i = first;
+    while (i < size_ && matches(i, key, h)) {
+      i++;
+    }
+    return i;
+  }
+
+  value_type *data() {
+    return heap_ ? heap_ : reinterpret_cast<value_type *>(inline_);
+  }
+  const value_type *data() const {
+    return heap_ ? heap_ : reinterpret_cast<const value_type *>(inline_);
+  }
+  uint32_t *hashes() { return heap_ ? heap_hashes_ : inline_hashes_; }
+  const uint32_t *hashes() const {
+    return heap_ ? heap_hashes_ : inline_hashes_;
+  }
+
+  void grow() {
+    auto capacity = capacity_ * 2;
+    auto fields = static_cast<value_type *>(
+        ::operator new(capacity * sizeof(value_type)));
+    auto hashes = new uint32_t[capacity];
+    for (size_t i = 0; i < size_; i++) {
+      new (fields + i) value_type(std::move(data()[i]));
+      data()[i].~value_type();
+      hashes[i] = this->hashes()[i];
+    }
+    release();
+    heap_ = fields;
+    heap_hashes_ = hashes;
+    capacity_ = capacity;
+  }
+
+  // Frees the heap storage (the fields must already be destroyed or moved)
+  void release() {
+    if (heap_) {
+      ::operator delete(heap_);
+      delete[] heap_hashes_;
+      heap_ = nullptr;
+      heap_hashes_ = nullptr;
+    }
+    capacity_ = inline_count_;
+  }
+
+  // Moves rhs's fields into this (which must be empty and not on the heap)
+  void take(FlatHeaders &rhs) {
+    if (rhs.heap_) {
+      heap_ = rhs.heap_;
+      heap_hashes_ = rhs.heap_hashes_;
+      capacity_ = rhs.capacity_;
+      size_ = rhs.size_;
+      rhs.heap_ = nullptr;
+      rhs.heap_hashes_ = nullptr;
+      rhs.capacity_ = inline_count_;
+      rhs.size_ = 0;
+    } else {
+      for (size_t i = 0; i < rhs.size_; i++) {
+        new (data() + i) value_type(std::move(rhs.data()[i]));
+        hashes()[i] = rhs.hashes()[i];
+      }
+      size_ = rhs.size_;
+      rhs.clear();
+    }
+  }
+
+  size_t size_ = 0;
+  size_t capacity_ = inline_count_;
+  value_type *heap_ = nullptr;
+  uint32_t *heap_hashes_ = nullptr;
+  typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type
+      inline_[inline_count_];
+  uint32_t inline_hashes_[inline_count_];
+};
+
+#ifdef CPPHTTPLIB_FLAT_HEADERS
+using Headers = FlatHeaders;
+#else
 using Headers = std::multimap<std::string, std::string, detail::ci>;
+#endif
 
 using Params = std::multimap<std::string, std::string>;
 using Match = std::smatch;
@@ -577,6 +851,13 @@ public:
   virtual void get_local_ip_and_port(std::string &ip, int &port) const = 0;
   virtual socket_t socket() const = 0;
 
+  // Exposes bytes that have been received but not read yet, waiting for some
+  // to arrive if there are none. Returns 0 if the stream keeps no read buffer
+  // and -1 if nothing could be received.
+  virtual ssize_t peek(const char *&ptr);
+  // Marks the first `size` bytes returned by peek() as read.
+  virtual void skip(size_t size);
+
   template <typename... Args>
   ssize_t write_format(const char *fmt, const Args &...args);
   ssize_t write(const char *ptr);
@@ -667,6 +948,146 @@ private:
   std::mutex mutex_;
 };
 
+// A TaskQueue that gives each worker its own queue instead of sharing one
+// list and one mutex. Enqueued tasks are spread across the queues round-robin.
+// A worker runs tasks from its own queue first and steals from the others
+// when its queue is empty. Each queue is a growable ring buffer of
+// std::function slots, so enqueueing doesn't allocate a list node (the task
+// itself is kept in std::function's small-object storage when its captures
+// fit). Select it with
+//   svr.new_task_queue = [] { return new WorkStealingPool(8); };
+class WorkStealingPool : public TaskQueue {
+public:
+  explicit WorkStealingPool(size_t n)
+      : queues_(n ? n : 1), next_(0), pending_(0), sleepers_(0),
+        shutdown_(false) {
+    for (size_t i = 0; i < queues_.size(); i++) {
+      threads_.emplace_back(worker(*this, i));
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  ~WorkStealingPool() override = default;
+
+  void enqueue(std::function<void()> fn) override {
+    auto &q = queues_[next_.fetch_add(1) % queues_.size()];
+    {
+      std::lock_guard<std::mutex> lock(q.mutex_);
+      // Counted before the task can be taken, so a worker that takes it
+      // right away can't decrement pending_ below zero
+      pending_.fetch_add(1);
+      q.push(std::move(fn));
+    }
+
+    // Only take the sleep lock when someone may be waiting on it
+    if (sleepers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      cond_.notify_one();
+    }
+  }
+
+  void shutdown() override {
+    // Stop all worker threads once the queues are drained...
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      shutdown_ = true;
+    }
+
+    cond_.notify_all();
+
+    // Join...
+    for (auto &t : threads_) {
+      t.join();
+    }
+  }
+
+private:
+  struct queue {
+    queue() : slots_(16), head_(0), count_(0) {}
+
+    void push(std::function<void()> fn) {
+      if (count_ == slots_.size()) { grow(); }
+      slots_[(head_ + count_) & (slots_.size() - 1)] = std::move(fn);
+      count_++;
+    }
+
+    bool pop(std::function<void()> &fn) {
+      if (count_ == 0) { return false; }
+      fn = std::move(slots_[head_]);
+      slots_[head_] = nullptr;
+      head_ = (head_ + 1) & (slots_.size() - 1);
+      count_--;
+      return true;
+    }
+
+    void grow() {
+      std::vector<std::function<void()>> slots(slots_.size() * 2);
+      for (size_t i = 0; i < count_; i++) {
+        slots[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+      }
+      slots_.swap(slots);
+      head_ = 0;
+    }
+
+    std::mutex mutex_;
+    std::vector<std::function<void()>> slots_; // size is a power of two
+    size_t head_;
+    size_t count_;
+    char pad_[64]; // keeps neighboring queues' locks off the same cache line
+  };
+
+  bool take(size_t self, std::function<void()> &fn) {
+    for (size_t i = 0; i < queues_.size(); i++) {
+      auto &q = queues_[(self + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(q.mutex_);
+      if (q.pop(fn)) {
+        pending_.fetch_sub(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  struct worker {
+    worker(WorkStealingPool &pool, size_t index) : pool_(pool), index_(index) {}
+
+    void operator()() {
+      for (;;) {
+        std::function<void()> fn;
+        if (!pool_.take(index_, fn)) {
+          std::unique_lock<std::mutex> lock(pool_.sleep_mutex_);
+          pool_.sleepers_.fetch_add(1);
+          pool_.cond_.wait(lock, [&] {
+            return pool_.pending_.load() > 0 || pool_.shutdown_;
+          });
+          pool_.sleepers_.fetch_sub(1);
+
+          if (pool_.shutdown_ && pool_.pending_.load() == 0) { break; }
+          continue;
+        }
+
+        assert(true == static_cast<bool>(fn));
+        fn();
+      }
+    }
+
+    WorkStealingPool &pool_;
+    size_t index_;
+  };
+  friend struct worker;
+
+  std::vector<std::thread> threads_;
+  std::vector<queue> queues_;
+  std::atomic<size_t> next_;
+  std::atomic<size_t> pending_;
+  std::atomic<size_t> sleepers_;
+
+  bool shutdown_;
+
+  std::condition_variable cond_;
+  std::mutex sleep_mutex_;
+};
+
 using Logger = std::function<void(const Request &, const Response &)>;
 
 using SocketOptions = std::function<void(socket_t sock)>;
@@ -725,6 +1146,28 @@ private:
   std::vector<std::string> param_names_;
 };
 
+/**
+ * Matches a pattern that has no regex metacharacters, which is what most
+ * registered routes look like. A miss is a plain string compare. A hit still
+ * runs std::regex_match on the pattern (compiled once, as a regex), since
+ * std::smatch can only be filled by a regex and handlers may read
+ * Request::matches (matches[0] is the whole path); a hit costs what it did
+ * with RegexMatcher.
+ */
+class LiteralMatcher : public MatcherBase {
+public:
+  LiteralMatcher(const std::string &pattern)
+      : pattern_(pattern), regex_(pattern) {}
+
+  bool match(Request &request) const override;
+
+  static bool is_literal(const std::string &pattern);
+
+private:
+  std::string pattern_;
+  std::regex regex_;
+};
+
 /**
  * Performs std::regex_match on request path
  * and stores the result in Request::matches
@@ -743,6 +1186,57 @@ private:
   std::regex regex_;
 };
 
+/**
+ * Index over the routes registered for one method, so that finding the
+ * handler for a path doesn't try every matcher in turn.
+ *
+ * Literal and path parameter patterns are split on '/' into a trie, where a
+ * ":name" segment matches any one path segment. Looking a path up walks one
+ * node per segment, however many routes there are. Patterns the trie can't
+ * represent (regexes, or a ':' that doesn't start a segment) are kept in a
+ * fallback list that is always included.
+ *
+ * Route i is the i-th pattern passed to add(). find() only narrows things
+ * down: its candidates still have to be confirmed with their matchers, in
+ * order, so the first registered route that matches still wins.
+ */
+class RouteIndex {
+public:
+  void add(const std::string &pattern);
+
+  // Sets candidates to the routes that may match path, in registration order.
+  // Doesn't allocate once candidates has grown to fit, so callers can keep
+  // reusing one vector.
+  void find(const std::string &path, std::vector<size_t> &candidates) const;
+
+private:
+  struct Node;
+  struct Child {
+    size_t hash; // of segment, see segment_hash()
+    std::string segment;
+    std::unique_ptr<Node> node;
+  };
+  struct Node {
+    // Sorted by hash, so a path segment can be looked up where it is in the
+    // path instead of being copied out for a map lookup
+    std::vector<Child> children;
+    std::unique_ptr<Node> param; // ":name" segment
+    std::vector<size_t> routes;  // routes whose pattern ends here
+  };
+
+  static size_t segment_hash(const char *s, size_t len);
+  static Node &add_child(Node &node, const std::string &segment);
+  static const Node *find_child(const Node &node, const char *segment,
+                                size_t len);
+
+  void collect(const Node &node, const std::string &path, size_t pos,
+               std::vector<size_t> &candidates) const;
+
+  Node root_;
+  std::vector<size_t> fallback_;
+  size_t count_ = 0;
+};
+
 ssize_t write_headers(Stream &strm, const Headers &headers);
 
 } // namespace detail
@@ -828,6 +1322,12 @@ public:
 
   Server &set_payload_max_length(size_t length);
 
+#ifdef CPPHTTPLIB_USE_EPOLL
+  // Serve keep-alive connections from one epoll loop instead of parking a
+  // task queue thread on each of them. Ignored by SSLServer.
+  Server &set_epoll_reactor(bool on);
+#endif
+
   bool bind_to_port(const std::string &host, int port, int socket_flags = 0);
   int bind_to_any_port(const std::string &host, int socket_flags = 0);
   bool listen_after_bind();
@@ -844,6 +1344,9 @@ protected:
   bool process_request(Stream &strm, bool close_connection,
                        bool &connection_closed,
                        const std::function<void(Request &)> &setup_request);
+  bool process_request(Stream &strm, Request &req, Response &res,
+                       bool close_connection, bool &connection_closed,
+                       const std::function<void(Request &)> &setup_request);
 
   std::atomic<socket_t> svr_sock_{INVALID_SOCKET};
   size_t keep_alive_max_count_ = CPPHTTPLIB_KEEPALIVE_MAX_COUNT;
@@ -871,17 +1374,35 @@ private:
                                 SocketOptions socket_options) const;
   int bind_internal(const std::string &host, int port, int socket_flags);
   bool listen_internal();
+  void set_socket_timeouts(socket_t sock) const;
+
+#ifdef CPPHTTPLIB_USE_EPOLL
+  virtual bool supports_epoll_reactor() const;
+  bool listen_epoll(TaskQueue &task_queue);
+  void process_epoll_request(socket_t sock);
+  void close_epoll_connection(socket_t sock);
+  void close_idle_epoll_connections();
+#endif
 
   bool routing(Request &req, Response &res, Stream &strm);
   bool handle_file_request(const Request &req, Response &res,
                            bool head = false);
-  bool dispatch_request(Request &req, Response &res, const Handlers &handlers);
+  template <typename T>
+  size_t find_route(Request &req, const T &handlers,
+                    const detail::RouteIndex &routes) const;
+  bool dispatch_request(Request &req, Response &res, const Handlers &handlers,
+                        const detail::RouteIndex &routes);
   bool
   dispatch_request_for_content_reader(Request &req, Response &res,
                                       ContentReader content_reader,
-                                      const HandlersForContentReader &handlers);
+                                      const HandlersForContentReader &handlers,
+                                      const detail::RouteIndex &routes);
 
   bool parse_request_line(const char *s, Request &req);
+  bool parse_request_line(const char *beg, const char *end, Request &req);
+#ifdef CPPHTTPLIB_ZERO_COPY_PARSING
+  bool parse_buffered_request_head(Stream &strm, Request &req);
+#endif
   void apply_ranges(const Request &req, Response &res,
                     std::string &content_type, std::string &boundary);
   bool write_response(Stream &strm, bool close_connection, const Request &req,
@@ -910,6 +1431,18 @@ private:
   std::atomic<bool> is_running_{false};
   std::atomic<bool> done_{false};
 
+#ifdef CPPHTTPLIB_USE_EPOLL
+  struct EpollConnection {
+    size_t remaining;  // requests left before keep_alive_max_count_
+    bool busy;         // a request is being processed on a worker
+    std::chrono::steady_clock::time_point idle_since;
+  };
+  bool epoll_reactor_ = false;
+  int epoll_fd_ = -1;
+  std::mutex epoll_mutex_; // guards epoll_connections_ and its epoll_ctl calls
+  std::unordered_map<socket_t, EpollConnection> epoll_connections_;
+#endif
+
   struct MountPointEntry {
     std::string mount_point;
     std::string base_dir;
@@ -931,6 +1464,18 @@ private:
   HandlersForContentReader delete_handlers_for_content_reader_;
   Handlers options_handlers_;
 
+  // One per handler list above, with the same patterns in the same order
+  detail::RouteIndex get_routes_;
+  detail::RouteIndex post_routes_;
+  detail::RouteIndex post_routes_for_content_reader_;
+  detail::RouteIndex put_routes_;
+  detail::RouteIndex put_routes_for_content_reader_;
+  detail::RouteIndex patch_routes_;
+  detail::RouteIndex patch_routes_for_content_reader_;
+  detail::RouteIndex delete_routes_;
+  detail::RouteIndex delete_routes_for_content_reader_;
+  detail::RouteIndex options_routes_;
+
   HandlerWithResponse error_handler_;
   ExceptionHandler exception_handler_;
   HandlerWithResponse pre_routing_handler_;
@@ -1172,6 +1717,10 @@ public:
   size_t is_socket_open() const;
   socket_t socket() const;
 
+  // Number of sockets this client has connected so far. Requests that reuse
+  // a kept-alive socket don't count.
+  size_t connection_count() const;
+
   void set_hostname_addr_map(std::map<std::string, std::string> addr_map);
 
   void set_default_headers(Headers headers);
@@ -1277,6 +1826,8 @@ protected:
   mutable std::mutex socket_mutex_;
   std::recursive_mutex request_mutex_;
 
+  std::atomic<size_t> connection_count_{0};
+
   // These are all protected under socket_mutex
   size_t socket_requests_in_flight_ = 0;
   std::thread::id socket_requests_are_from_thread_ = std::thread::id();
@@ -1554,6 +2105,10 @@ public:
   size_t is_socket_open() const;
   socket_t socket() const;
 
+  // Number of sockets this client has connected so far. Requests that reuse
+  // a kept-alive socket don't count.
+  size_t connection_count() const;
+
   void set_hostname_addr_map(std::map<std::string, std::string> addr_map);
 
   void set_default_headers(Headers headers);
@@ -1622,6 +2177,8 @@ public:
   long get_openssl_verify_result() const;
 
   SSL_CTX *ssl_context() const;
+
+  size_t tls_session_resumed_count() const;
 #endif
 
 private:
@@ -1654,6 +2211,9 @@ public:
 
 private:
   bool process_and_close_socket(socket_t sock) override;
+#ifdef CPPHTTPLIB_USE_EPOLL
+  bool supports_epoll_reactor() const override;
+#endif
 
   SSL_CTX *ctx_;
   std::mutex ctx_mutex_;
@@ -1683,6 +2243,10 @@ public:
 
   SSL_CTX *ssl_context() const;
 
+  // Number of connections whose TLS handshake resumed the session from a
+  // previous connection instead of doing a full handshake.
+  size_t tls_session_resumed_count() const;
+
 private:
   bool create_and_connect_socket(Socket &socket, Error &error) override;
   void shutdown_ssl(Socket &socket, bool shutdown_gracefully) override;
@@ -1711,6 +2275,13 @@ private:
 
   long verify_result_ = 0;
 
+  // Last session ticket handed out by the server, offered on reconnect
+  SSL_SESSION *session_ = nullptr;
+  std::mutex session_mutex_;
+  std::atomic<size_t> tls_session_resumed_count_{0};
+
+  static int new_session_callback(SSL *ssl, SSL_SESSION *session);
+
   friend class ClientImpl;
 };
 #endif
@@ -2020,6 +2591,11 @@ bool parse_multipart_boundary(const std::string &content_type,
 
 bool parse_range_header(const std::string &s, Ranges &ranges);
 
+std::string file_extension(const std::string &path);
+
+bool parse_status_line(const char *b, const char *e, std::string &version,
+                       int &status, std::string &reason);
+
 int close_socket(socket_t sock);
 
 ssize_t send_socket(socket_t sock, const void *ptr, size_t size, int flags);
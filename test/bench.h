@@ -0,0 +1,38 @@
+#ifndef MIZZOU_BENCH_H
+#define MIZZOU_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// results get added in here so the compiler can't drop the work being timed
+static volatile size_t benchSink = 0;
+
+// the iteration count from argv[1], or `fallback` if there isn't one
+inline size_t benchIterations(int argc, char** argv, size_t fallback) {
+    if (argc < 2) { return fallback; }
+    long n = strtol(argv[1], NULL, 10);
+    return n > 0 ? (size_t)n : fallback;
+}
+
+inline double benchNow() {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// calls f() n times, returns the average nanoseconds per call
+template <typename F>
+double nsPerCall(size_t n, F f) {
+    f(); // warm up
+    double begin = benchNow();
+    for (size_t i = 0; i < n; i++) { f(); }
+    return (benchNow() - begin) / n;
+}
+
+// prints an old-vs-new pair of timings
+inline void reportComparison(const char* what, const char* unit, double before, double after) {
+    printf("%-28s before %12.1f %s   after %12.1f %s   (%.2fx)\n",
+           what, before, unit, after, unit, after > 0 ? before / after : 0.0);
+}
+
+#endif
@@ -0,0 +1,138 @@
+// heap allocations the server makes per keep-alive request, counted with a replaced operator new
+// on every thread except the client's (this one)
+//
+// built once per combination of CPPHTTPLIB_REUSE_REQUEST_STORAGE and CPPHTTPLIB_FLAT_HEADERS (see
+// CMakeLists.txt), since both change httplib itself; run them all to compare. Without either flag
+// each request gets a fresh Request and Response, as before
+//
+// arguments: requests per kind (default 5000)
+
+#include "httplib.h"
+#include "bench.h"
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+
+#include <atomic>
+
+static std::atomic<size_t> allocations(0), allocatedBytes(0);
+static thread_local bool uncounted = false;
+
+// not inlined, as in bench_route_index.cpp
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (!uncounted) {
+        allocations++;
+        allocatedBytes += size;
+    }
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) { throw std::bad_alloc(); }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+int connectTo(int port) {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(s);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return s;
+}
+
+// sends `request` on `s` and reads the whole response (which has a Content-Length)
+bool roundTrip(int s, const std::string& request, std::string& response) {
+    if (send(s, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size()) { return false; }
+    response.clear();
+    char buf[4096];
+    for (;;) {
+        size_t head = response.find("\r\n\r\n");
+        if (head != std::string::npos) {
+            size_t length = response.find("Content-Length: ");
+            if (length == std::string::npos) { return false; }
+            if (response.size() >= head + 4 + strtoul(response.c_str() + length + 16, NULL, 10)) { return true; }
+        }
+        ssize_t n = recv(s, buf, sizeof(buf), 0);
+        if (n <= 0) { return false; }
+        response.append(buf, n);
+    }
+}
+
+int main(int argc, char** argv) {
+    uncounted = true;
+    size_t requests = benchIterations(argc, argv, 5000);
+
+    std::string get = "GET /bench?a=1&lang=en HTTP/1.1\r\n"
+                      "Host: example.com\r\n"
+                      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) Gecko/20100101 Firefox/118.0\r\n"
+                      "Accept: text/html,application/xhtml+xml\r\n"
+                      "Accept-Language: en-US,en;q=0.5\r\n"
+                      "Accept-Encoding: gzip, deflate\r\n"
+                      "Connection: keep-alive\r\n"
+                      "Cookie: session=abcdef0123456789\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "\r\n";
+    std::string post = "POST /echo HTTP/1.1\r\n"
+                       "Host: example.com\r\n"
+                       "Content-Type: application/json\r\n"
+                       "Content-Length: 64\r\n"
+                       "\r\n" + std::string(64, 'x');
+
+    httplib::Server server;
+    server.set_keep_alive_max_count(requests + 100);
+    server.set_tcp_nodelay(true); // otherwise each response's second write waits on a delayed ACK
+    server.Get("/bench", [](const httplib::Request& req, httplib::Response& res) {
+        res.set_content("{\"status\":\"ok\",\"lang\":\"" + req.get_param_value("lang") + "\"}", "application/json");
+    });
+    server.Post("/echo", [](const httplib::Request& req, httplib::Response& res) {
+        res.set_content(req.body, "application/json");
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread listener([&]() { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    const char* flags =
+#ifdef CPPHTTPLIB_REUSE_REQUEST_STORAGE
+        " REUSE_REQUEST_STORAGE"
+#endif
+#ifdef CPPHTTPLIB_FLAT_HEADERS
+        " FLAT_HEADERS"
+#endif
+        "";
+    printf("%zu keep-alive requests of each kind, flags:%s\n", requests, *flags ? flags : " none");
+
+    bool ok = true;
+    std::string response;
+    const std::string* kinds[] = {&get, &post};
+    for (const std::string* request : kinds) {
+        int s = connectTo(port);
+        // the first few grow the connection's buffers, where the flags let them be kept
+        for (int i = 0; i < 10 && s >= 0; i++) { ok = roundTrip(s, *request, response) && ok; }
+        size_t allocationsBefore = allocations, bytesBefore = allocatedBytes;
+        double begin = benchNow();
+        for (size_t i = 0; i < requests && ok && s >= 0; i++) { ok = roundTrip(s, *request, response); }
+        double elapsed = benchNow() - begin;
+        ok = ok && s >= 0 && response.compare(0, 15, "HTTP/1.1 200 OK") == 0;
+        printf("%-5s allocations %6.1f, bytes %7.0f, time %6.1f us per request\n", request == &get ? "GET" : "POST",
+               (double)(allocations - allocationsBefore) / requests, (double)(allocatedBytes - bytesBefore) / requests,
+               elapsed / requests / 1000);
+        if (s >= 0) { close(s); }
+    }
+
+    server.stop();
+    listener.join();
+    if (!ok) {
+        fprintf(stderr, "a request failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// the Headers container: std::multimap (the default) vs FlatHeaders (CPPHTTPLIB_FLAT_HEADERS),
+// doing what the server does with a request's headers: fill it from a typical 8-field browser
+// request head, look a few fields up, and drop it
+//
+// both are compared directly in this one build (FlatHeaders exists whether or not it's the
+// Headers type); random sequences of operations on the two have to agree first. operator new is
+// counted to show where the allocations went
+//
+// arguments: requests (default 200000)
+
+#include "httplib.h"
+#include "bench.h"
+
+#include <random>
+
+static size_t allocations = 0;
+
+// not inlined, as in bench_route_index.cpp
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) { throw std::bad_alloc(); }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+typedef std::multimap<std::string, std::string, httplib::detail::ci> MultimapHeaders;
+
+template <typename H>
+std::vector<std::string> valuesOf(const H& headers, const std::string& key) {
+    std::vector<std::string> values;
+    auto range = headers.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) { values.push_back(it->second); }
+    return values;
+}
+
+// random emplace/erase/copy/move sequences, after each of which every key has to look the same
+bool agree() {
+    std::mt19937 rng(3);
+    const char* keys[] = {"Host", "host", "Accept", "ACCEPT", "Cookie", "X-A", "x-a", "Content-Type",
+                          "a", "b", "c", "d", "e", "f", "g"};
+    const size_t keyCount = sizeof(keys) / sizeof(keys[0]);
+    for (int round = 0; round < 2000; round++) {
+        httplib::FlatHeaders flat;
+        MultimapHeaders multimap;
+        for (int op = 0; op < 40; op++) {
+            std::string key = keys[rng() % keyCount], value = std::to_string(rng() % 5);
+            int what = rng() % 10;
+            if (what < 6) {
+                flat.emplace(key, value);
+                multimap.emplace(key, value);
+            } else if (what < 8) {
+                flat.erase(key);
+                multimap.erase(key);
+            } else if (what == 8) {
+                auto a = flat.find(key);
+                auto b = multimap.find(key);
+                if ((a == flat.end()) != (b == multimap.end())) { return false; }
+                if (a != flat.end()) {
+                    flat.erase(a);
+                    multimap.erase(b);
+                }
+            } else {
+                httplib::FlatHeaders copy = flat;
+                httplib::FlatHeaders moved(std::move(copy));
+                flat = std::move(moved);
+            }
+            if (flat.size() != multimap.size()) { return false; }
+            for (const char* k : keys) {
+                if (flat.count(k) != multimap.count(k) || valuesOf(flat, k) != valuesOf(multimap, k)) { return false; }
+            }
+        }
+    }
+    return true;
+}
+
+// what read_headers and a handler do with one request's headers; returns something to sink
+template <typename H>
+size_t handleRequest(const std::string& head) {
+    H headers;
+    const char* p = head.data();
+    const char* end = p + head.size();
+    while (p < end) {
+        const char* eol = strstr(p, "\r\n");
+        if (eol == p) { break; }
+        const char* colon = std::find(p, eol, ':');
+        const char* value = colon + 1;
+        while (value < eol && *value == ' ') { value++; }
+        headers.emplace(std::string(p, colon), std::string(value, eol));
+        p = eol + 2;
+    }
+    size_t result = headers.count("Connection") + headers.count("content-length");
+    auto it = headers.find("Accept-Encoding");
+    if (it != headers.end()) { result += it->second.size(); }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t requests = benchIterations(argc, argv, 200000);
+
+    if (!agree()) {
+        fprintf(stderr, "FlatHeaders and std::multimap disagree\n");
+        return 1;
+    }
+
+    std::string head = "Host: dining.missouri.edu\r\n"
+                       "User-Agent: Mozilla/5.0 (Linux; Android 14) AppleWebKit/537.36\r\n"
+                       "Accept: text/html,application/xhtml+xml\r\n"
+                       "Accept-Language: en-US,en;q=0.9\r\n"
+                       "Accept-Encoding: gzip, deflate\r\n"
+                       "Connection: keep-alive\r\n"
+                       "If-None-Match: \"5f3a-1b2c\"\r\n"
+                       "Cache-Control: max-age=0\r\n"
+                       "\r\n";
+    if (handleRequest<MultimapHeaders>(head) != handleRequest<httplib::FlatHeaders>(head)) {
+        fprintf(stderr, "the two found different headers\n");
+        return 1;
+    }
+
+    size_t before = allocations;
+    double multimapNs = nsPerCall(requests, [&]() { benchSink += handleRequest<MultimapHeaders>(head); });
+    double multimapAllocs = (double)(allocations - before) / (requests + 1);
+    before = allocations;
+    double flatNs = nsPerCall(requests, [&]() { benchSink += handleRequest<httplib::FlatHeaders>(head); });
+    double flatAllocs = (double)(allocations - before) / (requests + 1);
+
+    printf("%zu requests with 8 header fields (before = std::multimap, after = FlatHeaders)\n", requests);
+    reportComparison("fill + 3 lookups", "ns", multimapNs, flatNs);
+    reportComparison("allocations per request", "", multimapAllocs, flatAllocs);
+    return 0;
+}
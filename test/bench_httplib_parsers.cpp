@@ -0,0 +1,145 @@
+// httplib's per-request parsing: the std::regex versions it used before vs the hand-written
+// parsers (file extensions, Range headers, status lines) and LiteralMatcher for plain routes
+//
+// the old and new parsers are first run on a few thousand generated inputs and have to agree
+
+#include "httplib.h"
+#include "bench.h"
+
+#include <random>
+
+namespace legacy {
+
+// as they were in httplib.cc (apart from the formatting)
+std::string file_extension(const std::string& path) {
+    std::smatch m;
+    static auto re = std::regex("\\.([a-zA-Z0-9]+)$");
+    if (std::regex_search(path, m, re)) { return m[1].str(); }
+    return std::string();
+}
+
+bool parse_range_header(const std::string& s, httplib::Ranges& ranges) try {
+    static auto re_first_range = std::regex(R"(bytes=(\d*-\d*(?:,\s*\d*-\d*)*))");
+    std::smatch m;
+    if (std::regex_match(s, m, re_first_range)) {
+        auto pos = static_cast<size_t>(m.position(1));
+        auto len = static_cast<size_t>(m.length(1));
+        auto all_valid_ranges = true;
+        httplib::detail::split(&s[pos], &s[pos + len], ',', [&](const char* b, const char* e) {
+            if (!all_valid_ranges) { return; }
+            static auto re_another_range = std::regex(R"(\s*(\d*)-(\d*))");
+            std::cmatch cm;
+            if (std::regex_match(b, e, cm, re_another_range)) {
+                ssize_t first = -1;
+                if (!cm.str(1).empty()) { first = static_cast<ssize_t>(std::stoll(cm.str(1))); }
+                ssize_t last = -1;
+                if (!cm.str(2).empty()) { last = static_cast<ssize_t>(std::stoll(cm.str(2))); }
+                if (first != -1 && last != -1 && first > last) {
+                    all_valid_ranges = false;
+                    return;
+                }
+                ranges.emplace_back(std::make_pair(first, last));
+            }
+        });
+        return all_valid_ranges;
+    }
+    return false;
+} catch (...) {
+    return false;
+}
+
+bool parse_status_line(const std::string& line, std::string& version, int& status, std::string& reason) {
+    static const std::regex re("(HTTP/1\\.[01]) (\\d{3})(?: (.*?))?\r\n");
+    std::cmatch m;
+    if (!std::regex_match(line.c_str(), m, re)) { return false; }
+    version = std::string(m[1]);
+    status = std::stoi(std::string(m[2]));
+    reason = std::string(m[3]);
+    return true;
+}
+
+} // namespace legacy
+
+// random strings built from pieces of the three formats
+std::string randomInput(std::mt19937& rng) {
+    static const char* pieces[] = {"a", "Z", "9", ".", "-", "/", " ", ",", "\t", "bytes=", "0", "1", "5",
+                                   "HTTP/1.1 ", "HTTP/1.0 ", "200", " OK", "\r\n", "\n", "\r",
+                                   "99999999999999999999"};
+    const size_t count = sizeof(pieces) / sizeof(pieces[0]);
+    std::string s;
+    for (int i = rng() % 7; i > 0; i--) { s += pieces[rng() % count]; }
+    return s;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = benchIterations(argc, argv, 200000);
+    namespace detail = httplib::detail;
+
+    std::mt19937 rng(1);
+    for (int i = 0; i < 20000; i++) {
+        std::string s = randomInput(rng);
+        if (legacy::file_extension(s) != detail::file_extension(s)) {
+            fprintf(stderr, "file_extension differs on [%s]\n", s.c_str());
+            return 1;
+        }
+        httplib::Ranges a, b;
+        bool oldRange = legacy::parse_range_header(s, a), newRange = detail::parse_range_header(s, b);
+        if (oldRange != newRange || (oldRange && a != b)) {
+            fprintf(stderr, "parse_range_header differs on [%s]\n", s.c_str());
+            return 1;
+        }
+        std::string v1, r1, v2, r2;
+        int s1 = 0, s2 = 0;
+        bool oldStatus = legacy::parse_status_line(s, v1, s1, r1);
+        bool newStatus = detail::parse_status_line(s.data(), s.data() + s.size(), v2, s2, r2);
+        if (oldStatus != newStatus || (oldStatus && (v1 != v2 || s1 != s2 || r1 != r2))) {
+            fprintf(stderr, "parse_status_line differs on [%s]\n", s.c_str());
+            return 1;
+        }
+    }
+
+    // both matchers have to give a hit the same matches
+    detail::RegexMatcher regexRoute("/locations");
+    detail::LiteralMatcher literalRoute("/locations");
+    httplib::Request hit, miss;
+    hit.path = "/locations";
+    miss.path = "/open";
+    if (!regexRoute.match(hit) || hit.matches.size() != 1 || hit.matches[0] != "/locations"
+        || !literalRoute.match(hit) || hit.matches.size() != 1 || hit.matches[0] != "/locations"
+        || literalRoute.match(miss) || !miss.matches.empty()) {
+        fprintf(stderr, "LiteralMatcher doesn't fill in matches like RegexMatcher\n");
+        return 1;
+    }
+
+    std::string path = "/static/img/logo.png";
+    std::string range = "bytes=0-499, 500-999";
+    std::string line = "HTTP/1.1 200 OK\r\n";
+    std::string version, reason;
+    int status;
+    httplib::Ranges ranges;
+
+    printf("%zu calls each (before = std::regex, after = hand-written)\n", iterations);
+    reportComparison("file extension", "ns",
+                     nsPerCall(iterations, [&]() { benchSink += legacy::file_extension(path).size(); }),
+                     nsPerCall(iterations, [&]() { benchSink += detail::file_extension(path).size(); }));
+    reportComparison("Range header", "ns",
+                     nsPerCall(iterations, [&]() {
+                         ranges.clear();
+                         benchSink += legacy::parse_range_header(range, ranges);
+                     }),
+                     nsPerCall(iterations, [&]() {
+                         ranges.clear();
+                         benchSink += detail::parse_range_header(range, ranges);
+                     }));
+    reportComparison("status line", "ns",
+                     nsPerCall(iterations, [&]() { benchSink += legacy::parse_status_line(line, version, status, reason); }),
+                     nsPerCall(iterations, [&]() {
+                         benchSink += detail::parse_status_line(line.data(), line.data() + line.size(), version, status,
+                                                                reason);
+                     }));
+    reportComparison("plain route, hit", "ns", nsPerCall(iterations, [&]() { benchSink += regexRoute.match(hit); }),
+                     nsPerCall(iterations, [&]() { benchSink += literalRoute.match(hit); }));
+    reportComparison("plain route, miss", "ns", nsPerCall(iterations, [&]() { benchSink += regexRoute.match(miss); }),
+                     nsPerCall(iterations, [&]() { benchSink += literalRoute.match(miss); }));
+    return 0;
+}
@@ -0,0 +1,143 @@
+// a server holding thousands of idle keep-alive connections: the task queue thread per connection
+// it used before vs the epoll reactor (Server::set_epoll_reactor), in the same build
+//
+// with a thread per connection, the idle connections occupy every task queue thread until their
+// keep-alive timeout runs out, so a request on a new connection (or on one of the idle ones)
+// waits behind them; with the reactor it's answered right away. Requests time out after a second,
+// which is what the "before" side usually reports
+//
+// argument: connections (default 10000, capped by how many fds this process may open, since the
+// client end of each connection is in the same process)
+
+#include "httplib.h"
+#include "bench.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+const double REQUEST_TIMEOUT_MS = 1000;
+
+int connectTo(int port) {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0) { return -1; }
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(s);
+        return -1;
+    }
+    timeval timeout;
+    timeout.tv_sec = (time_t)(REQUEST_TIMEOUT_MS / 1000);
+    timeout.tv_usec = 0;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return s;
+}
+
+// sends one keep-alive GET on `s` and reads the response; returns the milliseconds it took, or -1
+// if no complete response arrived before the timeout
+double timeRequest(int s) {
+    const char* request = "GET /ok HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    double begin = benchNow();
+    if (send(s, request, strlen(request), MSG_NOSIGNAL) != (ssize_t)strlen(request)) { return -1; }
+    std::string response;
+    char buf[512];
+    while (response.find("\r\n\r\nok") == std::string::npos) {
+        ssize_t n = recv(s, buf, sizeof(buf), 0);
+        if (n <= 0) { return -1; }
+        response.append(buf, n);
+    }
+    return (benchNow() - begin) / 1e6;
+}
+
+struct Result {
+    double connectMs;  // opening all the idle connections
+    double newMs;      // a request on a new connection while they're open
+    double idleMs;     // a request on the last of them
+};
+
+bool run(bool epoll, size_t connections, Result& result) {
+    httplib::Server server;
+    server.set_epoll_reactor(epoll);
+    server.Get("/ok", [](const httplib::Request&, httplib::Response& res) { res.set_content("ok", "text/plain"); });
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread listener([&]() { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    std::vector<int> idle;
+    double begin = benchNow();
+    for (size_t i = 0; i < connections; i++) {
+        int s = connectTo(port);
+        if (s < 0) { break; }
+        idle.push_back(s);
+    }
+    result.connectMs = (benchNow() - begin) / 1e6;
+    bool ok = idle.size() == connections;
+    if (!ok) { fprintf(stderr, "only %zu of %zu connections opened\n", idle.size(), connections); }
+
+    // let the server catch up on accepting them before timing anything
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    int fresh = connectTo(port);
+    result.newMs = fresh >= 0 ? timeRequest(fresh) : -1;
+    result.idleMs = idle.empty() ? -1 : timeRequest(idle.back());
+
+    if (fresh >= 0) { close(fresh); }
+    for (int s : idle) { close(s); }
+    server.stop();
+    listener.join();
+    return ok;
+}
+
+void reportRequest(const char* what, double before, double after) {
+    if (before >= 0 && after >= 0) {
+        reportComparison(what, "ms", before, after);
+        return;
+    }
+    char b[32], a[32];
+    snprintf(b, sizeof(b), before < 0 ? "timed out" : "%.2f ms", before);
+    snprintf(a, sizeof(a), after < 0 ? "timed out" : "%.2f ms", after);
+    printf("%-28s before %15s   after %15s   (timeout %.0f ms)\n", what, b, a, REQUEST_TIMEOUT_MS);
+}
+
+int main(int argc, char** argv) {
+    size_t connections = benchIterations(argc, argv, 10000);
+
+    // each connection takes two fds here (client and server end), plus some to spare
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    size_t fit = limit.rlim_cur > 200 ? (limit.rlim_cur - 100) / 2 : 50;
+    if (connections > fit) {
+        printf("the fd limit (%llu) only allows %zu connections, not %zu\n", (unsigned long long)limit.rlim_cur, fit,
+               connections);
+        connections = fit;
+    }
+
+    Result before, after;
+    if (!run(false, connections, before) || !run(true, connections, after)) { return 1; }
+
+    printf("%zu idle connections (before = task queue thread per connection, after = epoll reactor)\n",
+           connections);
+    reportComparison("open all connections", "ms", before.connectMs, after.connectMs);
+    reportRequest("request, new connection", before.newMs, after.newMs);
+    reportRequest("request, idle connection", before.idleMs, after.idleMs);
+
+    // the reactor has to answer both; the thread-per-connection server isn't expected to
+    if (after.newMs < 0 || after.idleMs < 0) {
+        fprintf(stderr, "the epoll reactor didn't answer a request\n");
+        return 1;
+    }
+    return 0;
+}
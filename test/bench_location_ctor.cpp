@@ -0,0 +1,101 @@
+// constructing 10k Locations: the original constructor, which formatted strHours up front with
+// std::string temporaries, vs the current one, which leaves formatting to formatHours/strHours
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+namespace legacy {
+
+// intToTimeStr and Location as they were before strHours became on demand
+// (unchanged apart from the comments; checkIfOpen is left out)
+std::string intToTimeStr(int timeInt) {
+    int hr24 = timeInt / 60;
+    int min = timeInt % 60;
+
+    int hr12;
+    bool isAM;
+    if (hr24 == 0) { hr12 = 12; isAM = true; }
+    else if (hr24 == 12) { hr12 = 12; isAM = false; }
+    else if (hr24 < 12) {
+        hr12 = hr24; isAM = true;
+    }
+    else {
+        hr12 = hr24 - 12; isAM = false;
+    }
+
+    std::string pStr;
+    if (isAM) { pStr = " AM"; }
+    else { pStr = " PM"; }
+    std::string minStr;
+    if (min < 10) { minStr = "0" + std::to_string(min); }
+    else { minStr = std::to_string(min); }
+    std::string hr12Str = std::to_string(hr12);
+    return hr12Str + ":" + minStr + pStr;
+}
+
+struct Location {
+    std::string name;
+    double latitude;
+    double longitude;
+    std::string strHours;
+    bool favorite;
+    bool open;
+    std::vector<TimeBlock> hours;
+
+    Location(const std::string& _name, double _latitude, double _longitude, const std::vector<TimeBlock>& _hours)
+        : name(_name), latitude(_latitude), longitude(_longitude), favorite(false), open(false), hours(_hours) {
+        strHours = "";
+        for (TimeBlock& tb : hours) {
+            strHours += tb.label + ": " + intToTimeStr(tb.start) + " to " + intToTimeStr(tb.end) + "\n";
+        }
+    }
+};
+
+} // namespace legacy
+
+int main(int argc, char** argv) {
+    size_t iterations = benchIterations(argc, argv, 20);
+    size_t count = argc > 2 ? strtoul(argv[2], NULL, 10) : 10000;
+
+    std::vector<TimeBlock> hours{TimeBlock{"Breakfast", 420, 600}, TimeBlock{"Lunch", 660, 870},
+                                 TimeBlock{"Dinner", 990, 1200}};
+    std::string name = "Plaza 900 Dining";
+
+    // the text is the same whether it's made up front or on demand
+    legacy::Location before(name, 0.0, 0.0, hours);
+    Location after(name, 0.0, 0.0, hours);
+    if (before.strHours != after.strHours()) {
+        fprintf(stderr, "strHours differs:\n%s\nvs\n%s\n", before.strHours.c_str(), after.strHours().c_str());
+        return 1;
+    }
+
+    double construct = nsPerCall(iterations, [&]() {
+        std::vector<legacy::Location> v;
+        v.reserve(count);
+        for (size_t i = 0; i < count; i++) { v.push_back(legacy::Location{name, 1.0, 2.0, hours}); }
+        benchSink += v.size();
+    });
+    double constructNow = nsPerCall(iterations, [&]() {
+        std::vector<Location> v;
+        v.reserve(count);
+        for (size_t i = 0; i < count; i++) { v.push_back(Location{name, 1.0, 2.0, hours}); }
+        benchSink += v.size();
+    });
+
+    // when the text is wanted after all: the old string vs formatHours into a stack buffer
+    std::vector<legacy::Location> oldLocations(count, before);
+    std::vector<Location> newLocations(count, after);
+    double format = nsPerCall(iterations, [&]() {
+        for (const legacy::Location& l : oldLocations) { benchSink += l.strHours.size(); }
+    });
+    double formatNow = nsPerCall(iterations, [&]() {
+        char buf[256];
+        for (const Location& l : newLocations) { benchSink += l.formatHours(buf, sizeof(buf)); }
+    });
+
+    printf("%zu Locations with %zu blocks each, %zu iterations\n", count, hours.size(), iterations);
+    reportComparison("construct all", "us", construct / 1000, constructNow / 1000);
+    reportComparison("then read the hours text", "us", format / 1000, formatNow / 1000);
+    reportComparison("construct + format", "us", (construct + format) / 1000, (constructNow + formatNow) / 1000);
+    return 0;
+}
@@ -0,0 +1,90 @@
+// "what's open at minute T": checking every Location's hours for each query (as before) vs an
+// OpenIndex built once, for every minute of the day over the locations of locations.html
+// repeated to a few thousand
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+int main(int argc, char** argv) {
+    size_t iterations = benchIterations(argc, argv, 20);
+    size_t count = argc > 2 ? strtoul(argv[2], NULL, 10) : 2000;
+
+    std::vector<Location> page = GetScheduleData("2023-12-04", true);
+    if (page.empty()) {
+        fprintf(stderr, "could not read locations.html\n");
+        return 1;
+    }
+    std::vector<Location> locations;
+    while (locations.size() < count) {
+        for (const Location& l : page) { locations.push_back(l); }
+    }
+
+    OpenIndex index(locations);
+    std::vector<uint64_t> during;
+
+    // the answers have to agree before the timings mean anything
+    for (int t = 0; t < 24 * 60; t++) {
+        for (size_t i = 0; i < locations.size(); i++) {
+            locations[i].checkIfOpen(ClockSnapshot::at(t));
+            if (locations[i].open != index.isOpenAt(i, t)) {
+                fprintf(stderr, "OpenIndex disagrees with checkIfOpen for %s at %d\n", locations[i].name.c_str(), t);
+                return 1;
+            }
+        }
+        index.openDuring(t, t + 60, during);
+        for (size_t i = 0; i < locations.size(); i++) {
+            bool open = false;
+            for (const TimeBlock& tb : locations[i].hours) { open = open || (tb.start <= t + 60 && t <= tb.end); }
+            if (open != (((during[i / 64] >> (i % 64)) & 1) != 0)) {
+                fprintf(stderr, "OpenIndex::openDuring disagrees for %s at %d\n", locations[i].name.c_str(), t);
+                return 1;
+            }
+        }
+    }
+
+    // one full day of point queries, counting the open locations at each minute
+    double scanDay = nsPerCall(iterations, [&]() {
+        for (int t = 0; t < 24 * 60; t++) {
+            ClockSnapshot clock = ClockSnapshot::at(t);
+            for (Location& l : locations) {
+                l.checkIfOpen(clock);
+                benchSink += l.open;
+            }
+        }
+    });
+    double indexDay = nsPerCall(iterations, [&]() {
+        for (int t = 0; t < 24 * 60; t++) {
+            const uint64_t* open = index.openAt(t);
+            for (size_t w = 0; w < index.words; w++) { benchSink += __builtin_popcountll(open[w]); }
+        }
+    });
+
+    // "open at any point in the next hour", for every minute of the day
+    double scanWindow = nsPerCall(iterations, [&]() {
+        for (int t = 0; t < 24 * 60; t++) {
+            for (const Location& l : locations) {
+                for (const TimeBlock& tb : l.hours) {
+                    if (tb.start <= t + 60 && t <= tb.end) {
+                        benchSink++;
+                        break;
+                    }
+                }
+            }
+        }
+    });
+    double indexWindow = nsPerCall(iterations, [&]() {
+        for (int t = 0; t < 24 * 60; t++) {
+            index.openDuring(t, t + 60, during);
+            for (size_t w = 0; w < index.words; w++) { benchSink += __builtin_popcountll(during[w]); }
+        }
+    });
+
+    double build = nsPerCall(iterations, [&]() { benchSink += OpenIndex(locations).boundaries.size(); });
+
+    printf("%zu locations, %zu segments, %zu iterations (before = scanning every Location, after = OpenIndex)\n",
+           locations.size(), index.boundaries.size(), iterations);
+    reportComparison("open at T, per query", "ns", scanDay / (24 * 60), indexDay / (24 * 60));
+    reportComparison("open within 1h, per query", "ns", scanWindow / (24 * 60), indexWindow / (24 * 60));
+    printf("building the index: %.1f us\n", build / 1000);
+    return 0;
+}
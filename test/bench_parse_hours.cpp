@@ -0,0 +1,159 @@
+// parseHrsStr: the original substr-based version vs the single-pass tokenizer, over the hours
+// text of every row in locations.html
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+namespace legacy {
+
+// parseHrsStr as it was before the single-pass rewrite (unchanged apart from the comments)
+std::vector<TimeBlock> parseHrsStr(std::string hrsStr) {
+    std::vector<TimeBlock> timeBlocks;
+
+    int beginIdx = 0;
+    while (std::isspace(hrsStr[beginIdx])) { beginIdx++; }
+    int endIdx = hrsStr.size() - 4;
+    while (std::isspace(hrsStr[endIdx])) { endIdx--; }
+    hrsStr = hrsStr.substr(beginIdx, endIdx - beginIdx + 1);
+
+    std::string hrsStrView = hrsStr; int pos = 0;
+
+    if (std::isdigit(hrsStr[0])) {
+        pos = hrsStrView.find(" ");
+        std::string startTimeStr = hrsStrView.substr(0, pos);
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+        pos = hrsStrView.find(" ");
+        std::string startTimePStr = hrsStrView.substr(0, pos);
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+        pos = hrsStrView.find(" ");
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+        pos = hrsStrView.find(" ");
+        std::string endTimeStr = hrsStrView.substr(0, pos);
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+        std::string endTimePStr = hrsStrView;
+        std::string startStr = startTimeStr + " " + startTimePStr;
+        std::string endStr = endTimeStr + " " + endTimePStr;
+        timeBlocks.push_back(TimeBlock{"Hours", timeStrToInt(startStr), timeStrToInt(endStr)});
+        return timeBlocks;
+    }
+
+    while (true) {
+        pos = hrsStrView.find(" ");
+        std::string label = hrsStrView.substr(0, pos);
+
+        while (std::isspace(hrsStrView[pos])) { pos++; }
+        hrsStrView = hrsStrView.substr(pos, hrsStrView.size() - 1);
+
+        pos = hrsStrView.find(" ");
+        std::string startTimeStr = hrsStrView.substr(0, pos);
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+
+        pos = hrsStrView.find(" ");
+        std::string startTimePStr = hrsStrView.substr(0, pos);
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+
+        pos = hrsStrView.find(" ");
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+
+        pos = hrsStrView.find(" ");
+        std::string endTimeStr = hrsStrView.substr(0, pos);
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+
+        std::string endTimePStr;
+        pos = hrsStrView.find(" ");
+        bool done = false;
+        if (pos == -1) {
+            endTimePStr = hrsStrView;
+            done = true;
+        }
+
+        if (!done) { endTimePStr = hrsStrView.substr(0, pos); }
+
+        std::string startStr = startTimeStr + " " + startTimePStr;
+        std::string endStr = endTimeStr + " " + endTimePStr;
+        timeBlocks.push_back(TimeBlock{label, timeStrToInt(startStr), timeStrToInt(endStr)});
+
+        if (done) { break; }
+
+        hrsStrView = hrsStrView.substr(pos + 1, hrsStrView.size() - 1);
+        pos = 0;
+
+        while (std::isspace(hrsStrView[pos])) { pos++; }
+        hrsStrView = hrsStrView.substr(pos, hrsStrView.size() - 1);
+    }
+
+    return timeBlocks;
+}
+
+} // namespace legacy
+
+// the text of the second <td> of every two-column row, i.e. what parseHrsStr gets fed
+void collectHoursText(xmlDoc* doc, xmlNode* node, std::vector<std::string>& out) {
+    for (; node; node = node->next) {
+        if (node->type == XML_ELEMENT_NODE && xmlStrcmp(node->name, BAD_CAST "tr") == 0) {
+            std::vector<xmlNode*> tds;
+            for (xmlNode* c = node->children; c; c = c->next) {
+                if (c->type == XML_ELEMENT_NODE && xmlStrcmp(c->name, BAD_CAST "td") == 0) { tds.push_back(c); }
+            }
+            if (tds.size() == 2) {
+                xmlChar* text = xmlNodeListGetString(doc, tds[1]->children, 1);
+                out.push_back(text ? (const char*)text : "");
+                xmlFree(text);
+            }
+        }
+        collectHoursText(doc, node->children, out);
+    }
+}
+
+// the times aren't compared: the old version reads an "AM" followed by a line break as "PM"
+// (e.g. Breakfast 7:00 AM - 10:00 AM came out as ending at 10:00 PM)
+bool sameLabels(const std::vector<TimeBlock>& a, const std::vector<TimeBlock>& b) {
+    if (a.size() != b.size()) { return false; }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].label != b[i].label) { return false; }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = benchIterations(argc, argv, 20000);
+
+    std::ifstream file("locations.html");
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    xmlDoc* doc = htmlReadMemory(html.c_str(), html.size(), NULL, NULL, HTML_PARSE_NOERROR);
+    if (doc == NULL) {
+        fprintf(stderr, "could not read locations.html\n");
+        return 1;
+    }
+    std::vector<std::string> rows;
+    collectHoursText(doc, xmlDocGetRootElement(doc), rows);
+    xmlFreeDoc(doc);
+
+    // rows without any hours (e.g. "Closed") are left out, the old version only handles times
+    std::vector<std::string> inputs;
+    for (const std::string& row : rows) {
+        std::vector<TimeBlock> blocks = parseHrsStr(row);
+        if (blocks.empty()) { continue; }
+        if (!sameLabels(blocks, legacy::parseHrsStr(row))) {
+            fprintf(stderr, "old and new parseHrsStr disagree on: %s\n", row.c_str());
+            return 1;
+        }
+        inputs.push_back(row);
+    }
+    if (inputs.empty()) {
+        fprintf(stderr, "no hours text found in locations.html\n");
+        return 1;
+    }
+
+    double before = nsPerCall(iterations, [&]() {
+        for (const std::string& s : inputs) { benchSink += legacy::parseHrsStr(s).size(); }
+    });
+    std::vector<TimeBlock> reused;
+    double after = nsPerCall(iterations, [&]() {
+        for (const std::string& s : inputs) { benchSink += parseHrsStr(s.data(), s.size(), reused); }
+    });
+
+    printf("parseHrsStr over %zu rows, %zu iterations\n", inputs.size(), iterations);
+    reportComparison("per row", "ns", before / inputs.size(), after / inputs.size());
+    return 0;
+}
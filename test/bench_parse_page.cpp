@@ -0,0 +1,154 @@
+// parseScheduleHtml: the original recursive tag searches vs the single-pass row walk, on a
+// synthetic page made by repeating the rows of locations.html a few thousand times
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+namespace legacy {
+
+// the tag search parseScheduleHtml used before (unchanged apart from the comments)
+void _getElementsByTagName(xmlNode* node, std::string name, std::vector<xmlNode*>& results) {
+    xmlNode* currNode = NULL;
+    for (currNode = node; currNode; currNode = currNode->next) {
+        if (currNode->type == XML_ELEMENT_NODE && std::string((const char*)currNode->name) == name) {
+            results.push_back(currNode);
+        }
+        _getElementsByTagName(currNode->children, name, results);
+    }
+}
+
+void getElementsByTagName(xmlNode* node, std::string name, std::vector<xmlNode*>& results) {
+    _getElementsByTagName(node->children, name, results);
+}
+
+// parseScheduleHtml with the old row and cell lookups; everything else (the libxml2 parse and
+// parseHrsStr) is the same, so only the walk differs
+int parseScheduleHtml(const std::string& html, std::vector<Location>& locations) {
+    xmlDoc* doc = htmlReadMemory(html.c_str(), html.size() + 1, NULL, NULL, HTML_PARSE_NOERROR);
+    if (doc == NULL) {
+        return 0;
+    }
+
+    xmlNode* root = xmlDocGetRootElement(doc);
+    std::vector<xmlNode*> results;
+    getElementsByTagName(root, "tr", results);
+    std::vector<TimeBlock> timeBlocks;
+    for (xmlNode* node : results) {
+        std::vector<xmlNode*> tdResults;
+        getElementsByTagName(node, "td", tdResults);
+        if (tdResults.size() == 2) {
+            xmlNode* aElem = tdResults[0]->children->next;
+            xmlChar* key = xmlNodeListGetString(doc, aElem->children, 1);
+            std::string locName = (const char*)key;
+            xmlFree(key);
+            key = xmlNodeListGetString(doc, tdResults[1]->children, 1);
+            parseHrsStr((const char*)key, xmlStrlen(key), timeBlocks);
+            xmlFree(key);
+            locations.push_back(Location{locName, 0.0, 0.0, timeBlocks});
+        }
+    }
+
+    xmlFreeDoc(doc);
+    return 1;
+}
+
+// just the walk: counts the two-cell rows the old way
+size_t countRows(xmlNode* root) {
+    std::vector<xmlNode*> results;
+    getElementsByTagName(root, "tr", results);
+    size_t count = 0;
+    for (xmlNode* node : results) {
+        std::vector<xmlNode*> tdResults;
+        getElementsByTagName(node, "td", tdResults);
+        if (tdResults.size() == 2) { count++; }
+    }
+    return count;
+}
+
+} // namespace legacy
+
+// the same count, walked the way parseScheduleHtml does now
+size_t countRows(xmlDoc* doc, xmlNode* root) {
+    TableTagNames names(doc);
+    size_t count = 0;
+    xmlNode* node = root;
+    while (node) {
+        if (!names.is(node, names.tr)) {
+            node = nextInSubtree(node, root, false);
+            continue;
+        }
+        int tdCount = 0;
+        for (xmlNode* cell = node->children; cell; cell = cell->next) {
+            if (names.is(cell, names.td)) { tdCount++; }
+        }
+        if (tdCount == 2) { count++; }
+        node = nextInSubtree(node, root, true);
+    }
+    return count;
+}
+
+// locations.html with the rows of its first table repeated until there are at least `rows`
+std::string syntheticPage(const std::string& html, size_t rows, size_t& rowsOut) {
+    size_t body = html.find("<tbody");
+    body = html.find('>', body) + 1;
+    size_t bodyEnd = html.find("</tbody>", body);
+    std::string tableRows = html.substr(body, bodyEnd - body);
+    size_t perCopy = 0;
+    for (size_t pos = 0; (pos = tableRows.find("<tr", pos)) != std::string::npos; pos++) { perCopy++; }
+
+    std::string page = html.substr(0, body);
+    rowsOut = perCopy;
+    page += tableRows;
+    while (rowsOut < rows) {
+        page += tableRows;
+        rowsOut += perCopy;
+    }
+    page += html.substr(bodyEnd);
+    return page;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = benchIterations(argc, argv, 20);
+    size_t rows = argc > 2 ? strtoul(argv[2], NULL, 10) : 5000;
+
+    std::ifstream file("locations.html");
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (html.find("<tbody") == std::string::npos) {
+        fprintf(stderr, "could not read locations.html\n");
+        return 1;
+    }
+    size_t actualRows;
+    std::string page = syntheticPage(html, rows, actualRows);
+
+    std::vector<Location> oldResult, newResult;
+    if (!legacy::parseScheduleHtml(page, oldResult) || !parseScheduleHtml(page, newResult)
+        || oldResult.size() != newResult.size() || newResult.empty()) {
+        fprintf(stderr, "old and new parseScheduleHtml disagree (%zu vs %zu locations)\n",
+                oldResult.size(), newResult.size());
+        return 1;
+    }
+
+    std::vector<Location> locations;
+    double before = nsPerCall(iterations, [&]() {
+        locations.clear();
+        legacy::parseScheduleHtml(page, locations);
+        benchSink += locations.size();
+    });
+    double after = nsPerCall(iterations, [&]() {
+        locations.clear();
+        parseScheduleHtml(page, locations);
+        benchSink += locations.size();
+    });
+
+    xmlDoc* doc = htmlReadMemory(page.c_str(), page.size() + 1, NULL, NULL, HTML_PARSE_NOERROR);
+    xmlNode* root = xmlDocGetRootElement(doc);
+    double walkBefore = nsPerCall(iterations, [&]() { benchSink += legacy::countRows(root); });
+    double walkAfter = nsPerCall(iterations, [&]() { benchSink += countRows(doc, root); });
+    xmlFreeDoc(doc);
+
+    printf("parseScheduleHtml on a %zu KB page, %zu rows (%zu locations), %zu iterations\n",
+           page.size() / 1024, actualRows, newResult.size(), iterations);
+    reportComparison("per page", "us", before / 1000, after / 1000);
+    reportComparison("walk only (already parsed)", "us", walkBefore / 1000, walkAfter / 1000);
+    return 0;
+}
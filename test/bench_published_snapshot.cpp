@@ -0,0 +1,133 @@
+// PublishedSnapshot under load: many reader threads taking ReadGuards back to back while one
+// writer publishes new snapshots as fast as it can
+//
+// every snapshot is built from a generation number that all of its fields encode, so a reader
+// that sees fields from two different snapshots, or a snapshot that has been freed and reused,
+// notices the mismatch; readers also check generations never go backwards. Any of those is a
+// failure (exit code 1). The time to take a ReadGuard and the time publish() takes (mostly waiting
+// for readers) are reported as percentiles
+//
+// arguments: publishes (default 20000), reader threads (default 2 per core); with many more
+// readers than cores, publish() mostly measures how long the scheduler takes to get back to a
+// reader that was preempted holding a guard
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+std::unique_ptr<const ScheduleSnapshot> makeSnapshot(uint32_t generation) {
+    std::string tag = "generation " + std::to_string(generation);
+    int start = generation % 1000;
+    std::vector<Location> locations;
+    for (uint32_t i = 0; i <= generation % 5; i++) {
+        locations.push_back(Location{tag, (double)generation, (double)i, {TimeBlock{tag, start, start + 60}}});
+    }
+    return std::unique_ptr<const ScheduleSnapshot>(new ScheduleSnapshot(tag, locations));
+}
+
+// the generation `s` was made from, or -1 if its fields don't agree with each other
+long checkSnapshot(const ScheduleSnapshot& s) {
+    if (s.date.compare(0, 11, "generation ") != 0) { return -1; }
+    uint32_t generation = (uint32_t)strtoul(s.date.c_str() + 11, NULL, 10);
+    int start = generation % 1000;
+    if (s.locations.size() != generation % 5 + 1 || s.openIndex.locationCount != s.locations.size()) { return -1; }
+    for (size_t i = 0; i < s.locations.size(); i++) {
+        const Location& l = s.locations[i];
+        if (l.name != s.date || l.latitude != generation || l.longitude != i || l.hours.size() != 1
+            || l.hours[0].label != s.date || l.hours[0].start != start || !s.openIndex.isOpenAt(i, start)) {
+            return -1;
+        }
+    }
+    return generation;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) { return 0; }
+    size_t k = std::min(samples.size() - 1, (size_t)(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+void reportLatency(const char* what, std::vector<double>& samples) {
+    double p50 = percentile(samples, 0.50), p99 = percentile(samples, 0.99), p999 = percentile(samples, 0.999);
+    double max = samples.empty() ? 0 : *std::max_element(samples.begin(), samples.end());
+    printf("%-22s p50 %9.0f ns   p99 %9.0f ns   p99.9 %9.0f ns   max %9.0f ns   (%zu samples)\n",
+           what, p50, p99, p999, max, samples.size());
+}
+
+// readers time every 8th ReadGuard, and keep at most this many samples each
+const size_t SAMPLE_EVERY = 8;
+const size_t MAX_SAMPLES = 1 << 20;
+
+int main(int argc, char** argv) {
+    size_t publishes = benchIterations(argc, argv, 20000);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t readerCount = argc > 2 ? strtoul(argv[2], NULL, 10) : 2 * cores;
+
+    PublishedSnapshot published;
+    published.publish(makeSnapshot(0));
+
+    std::atomic<bool> done(false);
+    std::atomic<long> torn(0), backwards(0);
+    std::atomic<unsigned long long> reads(0);
+    std::vector<std::vector<double>> readSamples(readerCount);
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < readerCount; r++) {
+        readers.emplace_back([&, r]() {
+            std::vector<double>& samples = readSamples[r];
+            samples.reserve(MAX_SAMPLES);
+            long last = 0;
+            unsigned long long n = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                bool timed = n++ % SAMPLE_EVERY == 0 && samples.size() < MAX_SAMPLES;
+                double begin = timed ? benchNow() : 0;
+                double acquired;
+                long generation;
+                {
+                    PublishedSnapshot::ReadGuard s(published);
+                    acquired = timed ? benchNow() : 0;
+                    generation = s.get() ? checkSnapshot(*s.get()) : -1;
+                }
+                if (timed) { samples.push_back(acquired - begin); }
+                if (generation < 0) { torn++; }
+                else if (generation < last) { backwards++; }
+                else { last = generation; }
+            }
+            reads += n;
+        });
+    }
+
+    std::vector<double> publishSamples;
+    publishSamples.reserve(publishes);
+    double begin = benchNow();
+    for (size_t g = 1; g <= publishes; g++) {
+        std::unique_ptr<const ScheduleSnapshot> next = makeSnapshot((uint32_t)g);
+        double publishBegin = benchNow();
+        published.publish(std::move(next));
+        publishSamples.push_back(benchNow() - publishBegin);
+    }
+    double elapsed = benchNow() - begin;
+    done = true;
+    for (std::thread& t : readers) { t.join(); }
+
+    std::vector<double> allReads;
+    for (std::vector<double>& samples : readSamples) { allReads.insert(allReads.end(), samples.begin(), samples.end()); }
+
+    printf("%zu readers, %zu publishes in %.1f ms (%.0f per second), %llu reads\n", readerCount, publishes,
+           elapsed / 1e6, publishes / (elapsed / 1e9), (unsigned long long)reads);
+    reportLatency("take a ReadGuard", allReads);
+    reportLatency("publish", publishSamples);
+
+    {
+        PublishedSnapshot::ReadGuard s(published);
+        if (checkSnapshot(*s.get()) != (long)publishes) {
+            fprintf(stderr, "the last snapshot published isn't the current one\n");
+            return 1;
+        }
+    }
+    if (torn != 0 || backwards != 0) {
+        fprintf(stderr, "%ld reads saw an inconsistent snapshot, %ld saw an older one than before\n",
+                (long)torn, (long)backwards);
+        return 1;
+    }
+    return 0;
+}
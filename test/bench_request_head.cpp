@@ -0,0 +1,124 @@
+// serving a request whose head is already in the receive buffer: copying it out line by line
+// through stream_line_reader (as before) vs parsing it where it is (CPPHTTPLIB_ZERO_COPY_PARSING)
+//
+// this is built against httplib with CPPHTTPLIB_ZERO_COPY_PARSING; the server falls back to the
+// line reader for streams that keep no read buffer, so one stream type here hands its bytes out
+// only through read() (before) and the other also exposes them through peek() (after). Every
+// byte read() hands out is a byte copied from the receive buffer
+//
+// arguments: requests (default 200000)
+
+#include "httplib.h"
+#include "bench.h"
+
+// a request held in memory, like a connection's receive buffer
+class MemoryStream : public httplib::Stream {
+public:
+    MemoryStream(const std::string& _data) : data(_data), offset(0), copied(0), written(0) {}
+
+    bool is_readable() const override { return true; }
+    bool is_writable() const override { return true; }
+
+    ssize_t read(char* ptr, size_t size) override {
+        size = std::min(size, data.size() - offset);
+        memcpy(ptr, data.data() + offset, size);
+        offset += size;
+        copied += size;
+        return (ssize_t)size;
+    }
+
+    ssize_t write(const char*, size_t size) override {
+        written += size;
+        return (ssize_t)size;
+    }
+
+    void get_remote_ip_and_port(std::string&, int&) const override {}
+    void get_local_ip_and_port(std::string&, int&) const override {}
+    socket_t socket() const override { return 0; }
+
+    const std::string& data;
+    size_t offset;
+    size_t copied;
+    size_t written;
+};
+
+// the same, but also exposing the unread bytes in place, as SocketStream does with its buffer
+class BufferedMemoryStream : public MemoryStream {
+public:
+    BufferedMemoryStream(const std::string& _data) : MemoryStream(_data) {}
+
+    ssize_t peek(const char*& ptr) override {
+        ptr = data.data() + offset;
+        return (ssize_t)(data.size() - offset);
+    }
+
+    void skip(size_t size) override { offset += size; }
+};
+
+// process_request is protected
+class BenchServer : public httplib::Server {
+public:
+    using Server::process_request;
+};
+
+// serves the request in `strm`, and checks it was all read and answered
+bool serve(BenchServer& server, MemoryStream& strm) {
+    bool closed = false;
+    return server.process_request(strm, false, closed, [](httplib::Request&) {}) && !closed
+           && strm.offset == strm.data.size() && strm.written > 0;
+}
+
+int main(int argc, char** argv) {
+    size_t requests = benchIterations(argc, argv, 200000);
+
+    std::string request = "GET /bench?a=1 HTTP/1.1\r\n"
+                          "Host: example.com\r\n"
+                          "User-Agent: Mozilla/5.0 (X11; Linux x86_64) Gecko/20100101 Firefox/118.0\r\n"
+                          "Accept: text/html,application/xhtml+xml\r\n"
+                          "Accept-Language: en-US,en;q=0.5\r\n"
+                          "Accept-Encoding: gzip, deflate\r\n"
+                          "Connection: keep-alive\r\n"
+                          "Cookie: session=abcdef0123456789\r\n"
+                          "Cache-Control: no-cache\r\n"
+                          "\r\n";
+
+    BenchServer server;
+    std::string seen;
+    server.Get("/bench", [&](const httplib::Request& req, httplib::Response& res) {
+        seen = req.get_param_value("a") + req.get_header_value("Cookie") + std::to_string(req.headers.size());
+        res.set_content("ok", "text/plain");
+    });
+
+    // both ways have to see the same request
+    MemoryStream lines(request);
+    BufferedMemoryStream inPlace(request);
+    if (!serve(server, lines)) {
+        fprintf(stderr, "the line reader didn't serve the request\n");
+        return 1;
+    }
+    std::string seenByLines = seen;
+    if (!serve(server, inPlace) || seen != seenByLines || lines.written != inPlace.written) {
+        fprintf(stderr, "the request was parsed differently in place\n");
+        return 1;
+    }
+
+    bool ok = true;
+    double before = nsPerCall(requests, [&]() {
+        MemoryStream strm(request);
+        ok = serve(server, strm) && ok;
+    });
+    double after = nsPerCall(requests, [&]() {
+        BufferedMemoryStream strm(request);
+        ok = serve(server, strm) && ok;
+    });
+    if (!ok) {
+        fprintf(stderr, "a request wasn't served\n");
+        return 1;
+    }
+
+    printf("%zu requests, %zu byte head (before = line reader, after = parsed in place)\n", requests,
+           request.size());
+    reportComparison("serve one request", "ns", before, after);
+    printf("%-28s before %12zu B    after %12zu B\n", "bytes copied per request", lines.copied, inPlace.copied);
+    return 0;
+}
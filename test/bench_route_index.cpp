@@ -0,0 +1,251 @@
+// finding the handler for a request among 1k routes: trying every matcher in turn (what
+// dispatch_request did first), the first RouteIndex (a trie of unordered_maps keyed by segment
+// copies, merged with std::inplace_merge), and the current RouteIndex, which looks segments up
+// in place and reuses one candidates buffer
+//
+// randomly generated route tables are checked against the linear walk first; operator new is
+// counted to show what each lookup allocates
+//
+// arguments: lookups (default 200000), routes (default 1000)
+
+#include "httplib.h"
+#include "bench.h"
+
+#include <random>
+#include <set>
+
+static size_t allocations = 0;
+
+// neither is inlined: gcc would otherwise see malloc and free paired with the other's builtin
+// and warn (-Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) { throw std::bad_alloc(); }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    free(p);
+}
+
+typedef std::vector<std::unique_ptr<httplib::detail::MatcherBase>> Matchers;
+
+namespace legacy {
+
+// RouteIndex as it was first added to httplib.cc (apart from the formatting)
+class RouteIndex {
+public:
+    void add(const std::string& pattern) {
+        auto index = count_++;
+        auto is_path_params = pattern.find("/:") != std::string::npos;
+        auto fits = is_path_params || httplib::detail::LiteralMatcher::is_literal(pattern);
+        for (auto pos = pattern.find(':'); fits && pos != std::string::npos; pos = pattern.find(':', pos + 1)) {
+            if (!is_path_params || pos == 0 || pattern[pos - 1] != '/') { fits = false; }
+        }
+        if (!fits) {
+            fallback_.push_back(index);
+            return;
+        }
+        auto node = &root_;
+        size_t pos = 0;
+        for (;;) {
+            auto slash = pattern.find('/', pos);
+            auto seg_end = slash == std::string::npos ? pattern.size() : slash;
+            if (is_path_params && seg_end > pos && pattern[pos] == ':') {
+                if (!node->param) { node->param.reset(new Node()); }
+                node = node->param.get();
+                if (slash == pattern.size() - 1) { node->routes.push_back(index); }
+            } else {
+                auto& child = node->children[pattern.substr(pos, seg_end - pos)];
+                if (!child) { child.reset(new Node()); }
+                node = child.get();
+            }
+            if (slash == std::string::npos) { break; }
+            pos = slash + 1;
+        }
+        node->routes.push_back(index);
+    }
+
+    void find(const std::string& path, std::vector<size_t>& candidates) const {
+        candidates.clear();
+        collect(root_, path, 0, candidates);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        auto mid = candidates.size();
+        candidates.insert(candidates.end(), fallback_.begin(), fallback_.end());
+        std::inplace_merge(candidates.begin(), candidates.begin() + mid, candidates.end());
+    }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, std::unique_ptr<Node>> children;
+        std::unique_ptr<Node> param;
+        std::vector<size_t> routes;
+    };
+
+    void collect(const Node& node, const std::string& path, size_t pos, std::vector<size_t>& candidates) const {
+        if (pos == std::string::npos) {
+            candidates.insert(candidates.end(), node.routes.begin(), node.routes.end());
+            return;
+        }
+        auto slash = path.find('/', pos);
+        auto seg_end = slash == std::string::npos ? path.size() : slash;
+        auto next = slash == std::string::npos ? std::string::npos : slash + 1;
+        auto visit = [&](const Node& child) {
+            collect(child, path, next, candidates);
+            if (next == path.size()) { candidates.insert(candidates.end(), child.routes.begin(), child.routes.end()); }
+        };
+        if (!node.children.empty()) {
+            auto it = node.children.find(path.substr(pos, seg_end - pos));
+            if (it != node.children.end()) { visit(*it->second); }
+        }
+        if (node.param) { visit(*node.param); }
+    }
+
+    Node root_;
+    std::vector<size_t> fallback_;
+    size_t count_ = 0;
+};
+
+} // namespace legacy
+
+// the matcher Server::make_matcher picks for a pattern
+std::unique_ptr<httplib::detail::MatcherBase> makeMatcher(const std::string& pattern) {
+    using namespace httplib::detail;
+    if (pattern.find("/:") != std::string::npos) { return std::unique_ptr<MatcherBase>(new PathParamsMatcher(pattern)); }
+    if (LiteralMatcher::is_literal(pattern)) { return std::unique_ptr<MatcherBase>(new LiteralMatcher(pattern)); }
+    return std::unique_ptr<MatcherBase>(new RegexMatcher(pattern));
+}
+
+int linearWalk(const Matchers& matchers, httplib::Request& req) {
+    for (size_t i = 0; i < matchers.size(); i++) {
+        if (matchers[i]->match(req)) { return (int)i; }
+    }
+    return -1;
+}
+
+// dispatch_request's lookup, with either index
+template <typename Index>
+int indexed(const Matchers& matchers, const Index& index, std::vector<size_t>& candidates, httplib::Request& req) {
+    index.find(req.path, candidates);
+    for (size_t i : candidates) {
+        if (matchers[i]->match(req)) { return (int)i; }
+    }
+    return -1;
+}
+
+// small random route tables and paths, where the three have to pick the same route
+bool agree() {
+    std::mt19937 rng(7);
+    const char* pathSegments[] = {"a", "b", "users", "", "1", "x:y"};
+    const char* patternSegments[] = {"a", "b", "users", "", ":id", ":name", "(.*)", "[0-9]+", "1"};
+    std::vector<size_t> candidates;
+    for (int round = 0; round < 2000; round++) {
+        Matchers matchers;
+        legacy::RouteIndex before;
+        httplib::detail::RouteIndex after;
+        for (int r = 1 + rng() % 8; r > 0; r--) {
+            std::string pattern;
+            std::set<std::string> params;
+            bool repeated = false;
+            for (int k = 1 + rng() % 4; k > 0; k--) {
+                std::string segment = patternSegments[rng() % 9];
+                if (segment[0] == ':') { repeated = repeated || !params.insert(segment).second; }
+                pattern += "/" + segment;
+            }
+            if (repeated) { continue; }
+            matchers.push_back(makeMatcher(pattern));
+            before.add(pattern);
+            after.add(pattern);
+        }
+        for (int q = 0; q < 50; q++) {
+            std::string path;
+            for (int k = 1 + rng() % 5; k > 0; k--) { path += std::string("/") + pathSegments[rng() % 6]; }
+            if (rng() % 5 == 0) { path += "/"; }
+            httplib::Request a, b, c;
+            a.path = b.path = c.path = path;
+            int expected = linearWalk(matchers, a);
+            if (indexed(matchers, before, candidates, b) != expected
+                || indexed(matchers, after, candidates, c) != expected
+                || (expected >= 0 && (a.path_params != c.path_params || a.matches.size() != c.matches.size()))) {
+                fprintf(stderr, "routes disagree on %s\n", path.c_str());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t lookups = benchIterations(argc, argv, 200000);
+    size_t routeCount = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000;
+
+    if (!agree()) { return 1; }
+
+    // a mix of plain routes, path parameters and a few regexes, like a larger API would have
+    Matchers matchers;
+    legacy::RouteIndex before;
+    httplib::detail::RouteIndex after;
+    for (size_t i = 0; i < routeCount; i++) {
+        std::string base = "/api/v1/resource" + std::to_string(i);
+        std::string pattern;
+        switch (i % 4) {
+        case 0: pattern = base; break;
+        case 1: pattern = base + "/:id"; break;
+        case 2: pattern = base + "/:id/items/:item"; break;
+        default: pattern = i % 500 == 3 ? base + "/([0-9]+)" : base + "/list"; break;
+        }
+        matchers.push_back(makeMatcher(pattern));
+        before.add(pattern);
+        after.add(pattern);
+    }
+
+    // paths for routes spread over the table, and one that matches nothing
+    std::vector<httplib::Request> requests(5);
+    size_t last = routeCount - routeCount % 4;
+    requests[0].path = "/api/v1/resource0";
+    requests[1].path = "/api/v1/resource" + std::to_string(last / 2 + 1) + "/42";
+    requests[2].path = "/api/v1/resource" + std::to_string(last - 2) + "/42/items/7";
+    requests[3].path = "/api/v1/resource" + std::to_string(last - 1) + "/list";
+    requests[4].path = "/api/v1/nothing/here";
+
+    std::vector<size_t> candidates;
+    size_t r = 0;
+    auto measure = [&](const std::function<int(httplib::Request&)>& lookup, double& ns, double& allocs) {
+        size_t allocated = allocations;
+        ns = nsPerCall(lookups, [&]() { benchSink += lookup(requests[r++ % requests.size()]); });
+        allocs = (double)(allocations - allocated) / (lookups + 1);
+    };
+
+    double linearNs, linearAllocs, trieNs, trieAllocs, nowNs, nowAllocs;
+    measure([&](httplib::Request& req) { return linearWalk(matchers, req); }, linearNs, linearAllocs);
+    measure([&](httplib::Request& req) { return indexed(matchers, before, candidates, req); }, trieNs, trieAllocs);
+    measure([&](httplib::Request& req) { return indexed(matchers, after, candidates, req); }, nowNs, nowAllocs);
+
+    // the index on its own, without confirming the candidates with their matchers
+    double findBeforeNs, findBeforeAllocs, findNs, findAllocs;
+    measure([&](httplib::Request& req) {
+        before.find(req.path, candidates);
+        return (int)candidates.size();
+    }, findBeforeNs, findBeforeAllocs);
+    measure([&](httplib::Request& req) {
+        after.find(req.path, candidates);
+        return (int)candidates.size();
+    }, findNs, findAllocs);
+
+    printf("%zu routes, %zu lookups over %zu paths (after = current RouteIndex)\n", routeCount, lookups,
+           requests.size());
+    reportComparison("lookup vs every matcher", "ns", linearNs, nowNs);
+    reportComparison("lookup vs first RouteIndex", "ns", trieNs, nowNs);
+    reportComparison("find() vs first RouteIndex", "ns", findBeforeNs, findNs);
+    printf("allocations per lookup: every matcher %.2f, first RouteIndex %.2f, current RouteIndex %.2f\n",
+           linearAllocs, trieAllocs, nowAllocs);
+    printf("(that includes the matchers' own: path_params and the regex routes)\n");
+    printf("allocations per find(): first RouteIndex %.2f, current RouteIndex %.2f\n", findBeforeAllocs, findAllocs);
+    if (findAllocs != 0) {
+        fprintf(stderr, "RouteIndex::find allocated with a buffer that was already big enough\n");
+        return 1;
+    }
+    return 0;
+}
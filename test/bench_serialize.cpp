@@ -0,0 +1,109 @@
+// handing locations to the Android side: the "|||" text format (serializeLocations, split and
+// re-parsed on the other side) vs the binary format (serializeLocationsBinary /
+// deserializeLocationsBinary), on the locations of locations.html repeated to a few thousand
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+namespace legacy {
+
+// splits s on every `delim` (no empty trailing piece is dropped)
+void split(const std::string& s, const char* delim, std::vector<std::string>& out) {
+    out.clear();
+    size_t delimLen = strlen(delim);
+    size_t pos = 0;
+    for (;;) {
+        size_t next = s.find(delim, pos);
+        if (next == std::string::npos) {
+            out.push_back(s.substr(pos));
+            return;
+        }
+        out.push_back(s.substr(pos, next - pos));
+        pos = next + delimLen;
+    }
+}
+
+// what the receiving side has to do with serializeLocations output: split it back apart and
+// parse every number (the way the Java side does with String.split and parseDouble/parseInt)
+// returns 0 on fail, 1 on success
+int parseSerializedLocations(const std::string& text, std::vector<Location>& out) {
+    out.clear();
+    std::vector<std::string> locs, fields, blocks, parts;
+    split(text, "||||", locs);
+    for (const std::string& loc : locs) {
+        split(loc, "|||", fields);
+        if (fields.size() != 7) { return 0; }
+        std::vector<TimeBlock> hours;
+        split(fields[6], "||", blocks);
+        for (const std::string& block : blocks) {
+            split(block, "|", parts);
+            if (parts.size() != 3) { return 0; }
+            hours.push_back(TimeBlock{parts[0], std::stoi(parts[1]), std::stoi(parts[2])});
+        }
+        Location l{fields[0], std::stod(fields[1]), std::stod(fields[2]), hours};
+        l.favorite = fields[4] == "1";
+        l.open = fields[5] == "1";
+        out.push_back(l);
+    }
+    return 1;
+}
+
+} // namespace legacy
+
+bool sameLocations(const std::vector<Location>& a, const std::vector<Location>& b) {
+    if (a.size() != b.size()) { return false; }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].name != b[i].name || a[i].latitude != b[i].latitude || a[i].longitude != b[i].longitude
+            || a[i].favorite != b[i].favorite || a[i].open != b[i].open || !sameHours(a[i].hours, b[i].hours)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = benchIterations(argc, argv, 200);
+    size_t count = argc > 2 ? strtoul(argv[2], NULL, 10) : 2000;
+
+    std::vector<Location> page = GetScheduleData("2023-12-04", true);
+    if (page.empty()) {
+        fprintf(stderr, "could not read locations.html\n");
+        return 1;
+    }
+    applyHardCodedCoordinates(page);
+    std::vector<Location> locations;
+    while (locations.size() < count) {
+        for (const Location& l : page) { locations.push_back(l); }
+    }
+    for (size_t i = 0; i < locations.size(); i += 3) { locations[i].favorite = true; }
+
+    std::string text = serializeLocations(locations);
+    std::string binary = serializeLocationsBinary(locations);
+    std::vector<Location> fromText, fromBinary;
+    if (!deserializeLocationsBinary(binary.data(), binary.size(), fromBinary) || !sameLocations(locations, fromBinary)) {
+        fprintf(stderr, "binary round trip failed\n");
+        return 1;
+    }
+    if (!legacy::parseSerializedLocations(text, fromText) || fromText.size() != locations.size()) {
+        fprintf(stderr, "could not parse the text format back\n");
+        return 1;
+    }
+
+    double encodeText = nsPerCall(iterations, [&]() { benchSink += serializeLocations(locations).size(); });
+    double encodeBinary = nsPerCall(iterations, [&]() { benchSink += serializeLocationsBinary(locations).size(); });
+    double decodeText = nsPerCall(iterations, [&]() {
+        legacy::parseSerializedLocations(text, fromText);
+        benchSink += fromText.size();
+    });
+    double decodeBinary = nsPerCall(iterations, [&]() {
+        deserializeLocationsBinary(binary.data(), binary.size(), fromBinary);
+        benchSink += fromBinary.size();
+    });
+
+    printf("%zu locations, %zu iterations (before = \"|||\" text, after = binary)\n", locations.size(), iterations);
+    reportComparison("encode", "us", encodeText / 1000, encodeBinary / 1000);
+    reportComparison("decode", "us", decodeText / 1000, decodeBinary / 1000);
+    reportComparison("round trip", "us", (encodeText + decodeText) / 1000, (encodeBinary + decodeBinary) / 1000);
+    reportComparison("size", "KB", text.size() / 1024.0, binary.size() / 1024.0);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// "nearest open locations" and "open locations within r meters" over 100k points: a linear
+// scan with the haversine formula (what answering them took before) vs SpatialIndex
+
+#include "mizzou_internal.h"
+#include "bench.h"
+
+#include <random>
+
+namespace legacy {
+
+double haversineMeters(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * M_PI / 180.0;
+    double dLon = (lon2 - lon1) * M_PI / 180.0;
+    double a = sin(dLat / 2) * sin(dLat / 2)
+             + cos(lat1 * M_PI / 180.0) * cos(lat2 * M_PI / 180.0) * sin(dLon / 2) * sin(dLon / 2);
+    return 2.0 * EARTH_RADIUS_METERS * asin(std::min(1.0, sqrt(a)));
+}
+
+// every open location's distance, then the k smallest
+size_t nearestOpen(const std::vector<Location>& locations, double latitude, double longitude,
+                   const uint64_t* openBits, size_t k, std::vector<Neighbor>& scratch, Neighbor* out) {
+    scratch.clear();
+    for (size_t i = 0; i < locations.size(); i++) {
+        if (!SpatialIndex::isOpen(openBits, (uint32_t)i)) { continue; }
+        double d = haversineMeters(latitude, longitude, locations[i].latitude, locations[i].longitude);
+        scratch.push_back(Neighbor{(uint32_t)i, d});
+    }
+    k = std::min(k, scratch.size());
+    std::partial_sort(scratch.begin(), scratch.begin() + k, scratch.end(), SpatialIndex::closer);
+    std::copy(scratch.begin(), scratch.begin() + k, out);
+    return k;
+}
+
+size_t openWithin(const std::vector<Location>& locations, double latitude, double longitude, double meters,
+                  const uint64_t* openBits) {
+    size_t count = 0;
+    for (size_t i = 0; i < locations.size(); i++) {
+        if (SpatialIndex::isOpen(openBits, (uint32_t)i)
+            && haversineMeters(latitude, longitude, locations[i].latitude, locations[i].longitude) <= meters) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace legacy
+
+int main(int argc, char** argv) {
+    size_t queries = benchIterations(argc, argv, 200);
+    size_t count = argc > 2 ? strtoul(argv[2], NULL, 10) : 100000;
+
+    // points scattered over campus, each open for four hours sometime during the day
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> lat(38.935, 38.950), lon(-92.335, -92.320), startMinute(0, 1200);
+    std::vector<Location> locations;
+    locations.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        int start = (int)startMinute(rng);
+        locations.push_back(Location{"x", lat(rng), lon(rng), {TimeBlock{"Hours", start, start + 240}}});
+    }
+
+    double buildStart = benchNow();
+    SpatialIndex index(locations);
+    OpenIndex openIndex(locations);
+    double build = benchNow() - buildStart;
+    const uint64_t* open = openIndex.openAt(12 * 60);
+
+    std::vector<std::pair<double, double>> points;
+    for (size_t q = 0; q < queries; q++) { points.push_back(std::make_pair(lat(rng), lon(rng))); }
+
+    // both ways have to find the same neighbors (to within rounding of the two formulas)
+    const size_t k = 5;
+    Neighbor fromIndex[k], fromScan[k];
+    std::vector<Neighbor> scratch, within(1024);
+    for (size_t q = 0; q < points.size() && q < 50; q++) {
+        size_t n = index.nearestOpen(points[q].first, points[q].second, open, k, fromIndex);
+        size_t m = legacy::nearestOpen(locations, points[q].first, points[q].second, open, k, scratch, fromScan);
+        if (n != m) {
+            fprintf(stderr, "nearestOpen found %zu, the scan %zu\n", n, m);
+            return 1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (fabs(fromIndex[i].meters - fromScan[i].meters) > 1e-3) {
+                fprintf(stderr, "neighbor %zu: %.6f m vs %.6f m\n", i, fromIndex[i].meters, fromScan[i].meters);
+                return 1;
+            }
+        }
+        size_t a = index.openWithin(points[q].first, points[q].second, 50, open, &within[0], within.size());
+        size_t b = legacy::openWithin(locations, points[q].first, points[q].second, 50, open);
+        if (a != b) {
+            fprintf(stderr, "openWithin found %zu, the scan %zu\n", a, b);
+            return 1;
+        }
+    }
+
+    size_t q = 0;
+    double scanNearest = nsPerCall(queries, [&]() {
+        const std::pair<double, double>& p = points[q++ % points.size()];
+        benchSink += legacy::nearestOpen(locations, p.first, p.second, open, k, scratch, fromScan);
+    });
+    double indexNearest = nsPerCall(queries, [&]() {
+        const std::pair<double, double>& p = points[q++ % points.size()];
+        benchSink += index.nearestOpen(p.first, p.second, open, k, fromIndex);
+    });
+    double scanWithin = nsPerCall(queries, [&]() {
+        const std::pair<double, double>& p = points[q++ % points.size()];
+        benchSink += legacy::openWithin(locations, p.first, p.second, 50, open);
+    });
+    double indexWithin = nsPerCall(queries, [&]() {
+        const std::pair<double, double>& p = points[q++ % points.size()];
+        benchSink += index.openWithin(p.first, p.second, 50, open, &within[0], within.size());
+    });
+
+    printf("%zu points (%zu indexed), %zu queries (before = haversine scan, after = SpatialIndex)\n",
+           locations.size(), index.points.size(), queries);
+    reportComparison("5 nearest open", "us", scanNearest / 1000, indexNearest / 1000);
+    reportComparison("open within 50 m", "us", scanWithin / 1000, indexWithin / 1000);
+    printf("building the SpatialIndex and OpenIndex: %.1f ms\n", build / 1e6);
+    return 0;
+}
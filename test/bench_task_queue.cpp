@@ -0,0 +1,60 @@
+// the server's task queues under a flood of tiny tasks: ThreadPool (one list behind one mutex,
+// what the server used before) vs WorkStealingPool (a ring buffer per worker), from one producer
+// (like the listening thread) and from several
+//
+// arguments: tasks (default 400000), workers (default 8)
+
+#include "httplib.h"
+#include "bench.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// enqueues `tasks` tasks from `producers` threads, then shuts the pool down once they've all run;
+// returns the nanoseconds per task, or -1 if a task got lost
+double nsPerTask(httplib::TaskQueue& pool, size_t tasks, size_t producers) {
+    std::atomic<size_t> done(0);
+    size_t each = tasks / producers;
+    double begin = benchNow();
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < each; i++) {
+                pool.enqueue([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    for (std::thread& t : threads) { t.join(); }
+    pool.shutdown();
+    double elapsed = benchNow() - begin;
+    if (done != each * producers) {
+        fprintf(stderr, "%zu of %zu tasks ran\n", (size_t)done, each * producers);
+        return -1;
+    }
+    return elapsed / (each * producers);
+}
+
+int main(int argc, char** argv) {
+    size_t tasks = benchIterations(argc, argv, 400000);
+    size_t workers = argc > 2 ? strtoul(argv[2], NULL, 10) : 8;
+
+    printf("%zu tasks, %zu workers (before = ThreadPool, after = WorkStealingPool)\n", tasks, workers);
+    const size_t producerCounts[] = {1, 4};
+    for (size_t producers : producerCounts) {
+        double before, after;
+        {
+            httplib::ThreadPool pool(workers);
+            before = nsPerTask(pool, tasks, producers);
+        }
+        {
+            httplib::WorkStealingPool pool(workers);
+            after = nsPerTask(pool, tasks, producers);
+        }
+        if (before < 0 || after < 0) { return 1; }
+        char what[64];
+        snprintf(what, sizeof(what), "%zu producer(s), per task", producers);
+        reportComparison(what, "ns", before, after);
+    }
+    return 0;
+}
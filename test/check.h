@@ -0,0 +1,23 @@
+#ifndef MIZZOU_CHECK_H
+#define MIZZOU_CHECK_H
+
+#include <stdio.h>
+
+// failed CHECKs are reported and counted; a test's main returns checkResult() at the end
+// (plain C, so the C harness can use it too)
+static int checkFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            checkFailures++; \
+        } \
+    } while (0)
+
+static int checkResult(void) {
+    if (checkFailures) { fprintf(stderr, "%d check(s) failed\n", checkFailures); }
+    return checkFailures ? 1 : 0;
+}
+
+#endif
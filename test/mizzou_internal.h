@@ -0,0 +1,10 @@
+#ifndef MIZZOU_INTERNAL_H
+#define MIZZOU_INTERNAL_H
+
+// MizzouDining.cpp is a single translation unit with no header for its internals, so the tests
+// and benchmarks include it whole, with its main renamed out of the way
+#define main mizzou_main
+#include "MizzouDining.cpp"
+#undef main
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MIZZOU_PAGE_SERVER_H
+#define MIZZOU_PAGE_SERVER_H
+
+// (include mizzou_internal.h first)
+
+#include <atomic>
+#include <chrono>
+
+// a stand-in for the dining site on 127.0.0.1: one locations page, with an ETag that changes
+// whenever the page does, and an optional delay before each answer
+struct PageServer {
+    httplib::Server server;
+    std::mutex mutex;
+    std::string page;
+    std::string etag;
+    int sent;        // 200s
+    int notModified; // 304s
+    std::atomic<int> delayMs;
+    std::thread listener;
+    std::string host;
+
+    PageServer(const std::string& html) : sent(0), notModified(0), delayMs(0) {
+        setPage(html);
+        server.Get("/locations/", [this](const httplib::Request& req, httplib::Response& res) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            std::lock_guard<std::mutex> guard(mutex);
+            if (req.get_header_value("If-None-Match") == etag) {
+                notModified++;
+                res.status = 304;
+                return;
+            }
+            sent++;
+            res.set_header("ETag", etag);
+            res.set_content(page, "text/html");
+        });
+        server.set_keep_alive_timeout(1);
+        int port = server.bind_to_any_port("127.0.0.1");
+        listener = std::thread([this]() { server.listen_after_bind(); });
+        server.wait_until_ready();
+        host = "http://127.0.0.1:" + std::to_string(port);
+    }
+
+    ~PageServer() {
+        stop();
+    }
+
+    void stop() {
+        server.stop();
+        if (listener.joinable()) { listener.join(); }
+    }
+
+    void setPage(const std::string& html) {
+        std::lock_guard<std::mutex> guard(mutex);
+        page = html;
+        etag = "\"" + std::to_string((unsigned long long)fnv1a(html.data(), html.size())) + "\"";
+    }
+};
+
+#endif
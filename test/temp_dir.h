@@ -0,0 +1,30 @@
+#ifndef MIZZOU_TEMP_DIR_H
+#define MIZZOU_TEMP_DIR_H
+
+#include <ftw.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+
+// a fresh directory under /tmp, removed (with everything in it) when this goes away
+struct TempDir {
+    std::string path;
+
+    TempDir() {
+        char name[] = "/tmp/mizzou_test_XXXXXX";
+        if (mkdtemp(name) != NULL) { path = name; }
+    }
+
+    ~TempDir() {
+        if (!path.empty()) { nftw(path.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS); }
+    }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    static int removeEntry(const char* p, const struct stat*, int, struct FTW*) {
+        return remove(p);
+    }
+};
+
+#endif
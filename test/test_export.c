@@ -0,0 +1,116 @@
+/* the C API in MizzouDining.h, driven from plain C the way the Android bridge uses it:
+ * size-then-fill exports (through a held schedule and through mizzou_export_schedule), and a
+ * failed fetch reported as such instead of as an empty schedule */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "MizzouDining.h"
+#include "check.h"
+
+static void allocArrays(MizzouLocationArrays* a) {
+    a->locationCapacity = a->locationCount;
+    a->stringCapacity = a->stringCount;
+    a->strByteCapacity = a->strByteCount;
+    a->blockCapacity = a->blockCount;
+    a->strBytes = malloc(a->strByteCount + 1);
+    a->strOffsets = malloc(4 * (a->stringCount + 1));
+    a->latitudes = malloc(8 * a->locationCount + 1);
+    a->longitudes = malloc(8 * a->locationCount + 1);
+    a->blockOffsets = malloc(4 * (a->locationCount + 1));
+    a->blockStarts = malloc(2 * a->blockCount + 1);
+    a->blockEnds = malloc(2 * a->blockCount + 1);
+    a->blockLabels = malloc(4 * a->blockCount + 1);
+    a->openBits = malloc((a->locationCount + 7) / 8 + 1);
+    a->favoriteBits = malloc((a->locationCount + 7) / 8 + 1);
+}
+
+static void freeArrays(MizzouLocationArrays* a) {
+    free(a->strBytes);
+    free(a->strOffsets);
+    free(a->latitudes);
+    free(a->longitudes);
+    free(a->blockOffsets);
+    free(a->blockStarts);
+    free(a->blockEnds);
+    free(a->blockLabels);
+    free(a->openBits);
+    free(a->favoriteBits);
+}
+
+static int stringIs(const MizzouLocationArrays* a, uint32_t i, const char* s) {
+    uint32_t len = a->strOffsets[i + 1] - a->strOffsets[i];
+    return len == strlen(s) && memcmp(a->strBytes + a->strOffsets[i], s, len) == 0;
+}
+
+/* checks that a filled export is internally consistent */
+static void checkArrays(const MizzouLocationArrays* a) {
+    uint32_t i, b;
+    int foundBaja = 0;
+    CHECK(a->locationCount > 0);
+    CHECK(a->strOffsets[0] == 0 && a->strOffsets[a->stringCount] == a->strByteCount);
+    CHECK(a->blockOffsets[0] == 0 && a->blockOffsets[a->locationCount] == a->blockCount);
+    for (i = 0; i < a->locationCount; i++) {
+        CHECK(a->strOffsets[i] < a->strOffsets[i + 1]);
+        CHECK(a->blockOffsets[i] <= a->blockOffsets[i + 1]);
+        for (b = a->blockOffsets[i]; b < a->blockOffsets[i + 1]; b++) {
+            CHECK(a->blockLabels[b] >= a->locationCount && a->blockLabels[b] < a->stringCount);
+            CHECK(a->blockStarts[b] < 24 * 60 && a->blockEnds[b] < 24 * 60);
+        }
+        if (stringIs(a, i, "Baja Grill")) {
+            foundBaja = 1;
+            CHECK(a->latitudes[i] > 38.9 && a->latitudes[i] < 39.0);
+            CHECK(a->blockOffsets[i + 1] - a->blockOffsets[i] == 1);
+            CHECK(a->blockStarts[a->blockOffsets[i]] == 10 * 60 + 30);
+        }
+    }
+    CHECK(foundBaja);
+}
+
+int main(void) {
+    MizzouLocationArrays a, b;
+    MizzouSchedule* schedule;
+    char cwd[4096];
+    char emptyDir[] = "/tmp/mizzou_test_XXXXXX";
+
+    /* a held schedule: export it once to learn the sizes, then again into arrays that big */
+    memset(&a, 0, sizeof(a));
+    schedule = mizzou_fetch_schedule("2023-12-04", 1);
+    CHECK(schedule != NULL);
+    if (schedule != NULL) {
+        CHECK(mizzou_export(schedule, &a) == MIZZOU_EXPORT_TOO_SMALL);
+        CHECK(a.locationCount > 0 && a.stringCount > a.locationCount && a.blockCount > 0);
+        allocArrays(&a);
+        CHECK(mizzou_export(schedule, &a) == MIZZOU_EXPORT_OK);
+        checkArrays(&a);
+        mizzou_free_schedule(schedule);
+    }
+
+    /* the one-call version, with the same protocol; the retry exports what the first call
+     * fetched, so it works even though locations.html can't be read any more by then */
+    CHECK(getcwd(cwd, sizeof(cwd)) != NULL);
+    CHECK(mkdtemp(emptyDir) != NULL);
+    memset(&b, 0, sizeof(b));
+    CHECK(mizzou_export_schedule("2023-12-04", 1, &b) == MIZZOU_EXPORT_TOO_SMALL);
+    CHECK(b.locationCount == a.locationCount && b.blockCount == a.blockCount);
+    allocArrays(&b);
+    CHECK(chdir(emptyDir) == 0);
+    CHECK(mizzou_export_schedule("2023-12-04", 1, &b) == MIZZOU_EXPORT_OK);
+    checkArrays(&b);
+    CHECK(b.strByteCount == a.strByteCount && memcmp(a.strBytes, b.strBytes, a.strByteCount) == 0);
+
+    /* with no locations.html to read (and nothing held), the fetch fails, which is not the same
+     * as too small */
+    CHECK(mizzou_fetch_schedule("2023-12-04", 1) == NULL);
+    CHECK(mizzou_export_schedule("2023-12-04", 1, &b) == MIZZOU_EXPORT_FETCH_FAILED);
+    CHECK(chdir(cwd) == 0 && rmdir(emptyDir) == 0);
+
+    /* big enough arrays work on the first call */
+    CHECK(mizzou_export_schedule("2023-12-04", 1, &b) == MIZZOU_EXPORT_OK);
+    checkArrays(&b);
+
+    freeArrays(&a);
+    freeArrays(&b);
+    return checkResult();
+}
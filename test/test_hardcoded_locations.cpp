@@ -0,0 +1,59 @@
+// findHardCodedLocation: exact names, the normalized fallback (case, accents, "&" vs "and",
+// punctuation and spacing), names that match nothing, and applyHardCodedCoordinates
+
+#include "mizzou_internal.h"
+#include "check.h"
+
+// whether `name` finds the hardcoded location called `expected`
+bool finds(const std::string& name, const char* expected) {
+    const HardCodedLocation& hcl = findHardCodedLocation(name);
+    return &hcl != &unknownHardCodedLocation && strcmp(hcl.name, expected) == 0;
+}
+
+bool unknown(const std::string& name) {
+    return &findHardCodedLocation(name) == &unknownHardCodedLocation;
+}
+
+int main() {
+    // every name finds itself
+    for (const HardCodedLocation& hcl : hardcodedLocations) {
+        CHECK(&findHardCodedLocation(hcl.name) == &hcl);
+    }
+
+    CHECK(normalizeLocationName("Bookmark Café") == "bookmark cafe");
+    CHECK(normalizeLocationName("Pizza & MO") == "pizza and mo");
+    CHECK(normalizeLocationName("  Do Mundo's ") == "do mundos");
+    CHECK(normalizeLocationName("Mizzou Market - Southwest") == "mizzou market southwest");
+    CHECK(normalizeLocationName("ÀÉÎÕÜ") == "aeiou");
+    CHECK(normalizeLocationName("").empty());
+
+    // near misses go through the normalized names
+    CHECK(finds("Bookmark Cafe", "Bookmark Café"));
+    CHECK(finds("bookmark café", "Bookmark Café"));
+    CHECK(finds("BOOKMARK CAFÉ", "Bookmark Café"));
+    CHECK(finds("pizza and mo", "Pizza & MO"));
+    CHECK(finds("  Wings   &  MO ", "Wings & MO"));
+    CHECK(finds("Do Mundos", "Do Mundo's"));
+    CHECK(finds("Mizzou Market Southwest", "Mizzou Market - Southwest"));
+    CHECK(finds("Infusion", "infusion"));
+    CHECK(finds("Potential Energy Cafe", "Potential Energy Café"));
+
+    // and names that match nothing, exactly or normalized, get the unknown location
+    CHECK(unknown("Not A Real Place"));
+    CHECK(unknown(""));
+    CHECK(unknown("Bookmark"));
+    CHECK(unknown("Bookmark Cafes"));
+    CHECK(unknownHardCodedLocation.latitude == 0.0 && unknownHardCodedLocation.longitude == 0.0);
+
+    // applyHardCodedCoordinates fills in what it finds and leaves the rest at 0.0, 0.0
+    std::vector<Location> locations = {
+        Location("Bookmark Cafe", 0.0, 0.0, std::vector<TimeBlock>()),
+        Location("Not A Real Place", 0.0, 0.0, std::vector<TimeBlock>()),
+    };
+    applyHardCodedCoordinates(locations);
+    const HardCodedLocation& bookmark = findHardCodedLocation("Bookmark Café");
+    CHECK(locations[0].latitude == bookmark.latitude && locations[0].longitude == bookmark.longitude);
+    CHECK(locations[1].latitude == 0.0 && locations[1].longitude == 0.0);
+
+    return checkResult();
+}
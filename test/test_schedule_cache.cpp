@@ -0,0 +1,145 @@
+// the on-disk page cache (ScheduleCache / fetchThroughCache) against a local httplib::Server
+// that supports If-None-Match: fresh hits, 304 revalidation (also forced), pages replaced and
+// evicted, the streaming path (written to disk as it arrives), stale copies when the server is
+// gone, and concurrent atomic writes
+
+#include "mizzou_internal.h"
+#include "check.h"
+#include "temp_dir.h"
+#include "page_server.h"
+
+size_t countFiles(const std::string& dir, const char* suffix) {
+    size_t count = 0;
+    size_t suffixLen = strlen(suffix);
+    DIR* d = opendir(dir.c_str());
+    if (d == NULL) { return 0; }
+    while (struct dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name.size() > suffixLen && name.compare(name.size() - suffixLen, suffixLen, suffix) == 0) { count++; }
+    }
+    closedir(d);
+    return count;
+}
+
+// makes the cached copy of `date` old enough that the next fetch has to ask the server
+void makeStale(ScheduleCache& cache, const std::string& date) {
+    CachedPageMeta meta;
+    CHECK(cache.loadMeta(date, meta));
+    meta.fetched = time(NULL) - CACHE_MAX_AGE - 1;
+    cache.storeMeta(date, meta);
+}
+
+int main() {
+    std::ifstream file("locations.html");
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(!html.empty());
+    std::vector<Location> expected;
+    CHECK(parseScheduleHtml(html, expected));
+    // the same hours, but a different page (and so a different hash and ETag)
+    std::string changed = html + "<!-- changed -->";
+
+    TempDir dir;
+    ScheduleCache cache(dir.path);
+    PageServer server(html);
+    std::string pages = dir.path + "/pages";
+    std::vector<Location> locations;
+
+    // first fetch downloads and stores the page
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", false, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 1 && cache.stats.misses == 1);
+    CHECK(countFiles(pages, ".html") == 1);
+
+    // then it's fresh, so the server isn't asked (streaming or not)
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", false, locations));
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", true, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 1 && server.notModified == 0 && cache.stats.hits == 2);
+
+    // once stale, the server is asked and answers 304
+    makeStale(cache, "2023-12-04");
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", true, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 1 && server.notModified == 1 && cache.stats.revalidations == 1);
+
+    // asked to revalidate (as the background refresher does), the server is asked even though
+    // the copy was just fetched
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", false, locations, true));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 1 && server.notModified == 2 && cache.stats.revalidations == 2);
+
+    // a second date with the same page shares its file
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-05", true, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 2);
+    CHECK(countFiles(pages, ".html") == 1);
+
+    // the page changes: the first date moves to the new page, but the old one is kept for the
+    // second date until that moves too
+    server.setPage(changed);
+    makeStale(cache, "2023-12-04");
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", true, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 3);
+    CHECK(countFiles(pages, ".html") == 2);
+
+    // the streamed page was written to its file as it arrived, and that file is the page whole
+    CachedPageMeta streamedMeta;
+    CHECK(cache.loadMeta("2023-12-04", streamedMeta));
+    std::ifstream streamedFile(cache.pagePath(streamedMeta.hash), std::ios::binary);
+    CHECK(std::string((std::istreambuf_iterator<char>(streamedFile)), std::istreambuf_iterator<char>()) == changed);
+
+    makeStale(cache, "2023-12-05");
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-05", false, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(server.sent == 4);
+    CHECK(countFiles(pages, ".html") == 1);
+    CachedPageMeta a, b;
+    CHECK(cache.loadMeta("2023-12-04", a) && cache.loadMeta("2023-12-05", b) && a.hash == b.hash);
+    // and the downloads' temporary files are all gone, whether they were renamed into place or
+    // dropped (304s, and pages that were already stored)
+    size_t incoming = 0;
+    DIR* pagesDir = opendir(pages.c_str());
+    while (struct dirent* entry = readdir(pagesDir)) {
+        if (strncmp(entry->d_name, "incoming.", 9) == 0) { incoming++; }
+    }
+    closedir(pagesDir);
+    CHECK(incoming == 0);
+
+    // a stale copy is used when the server can't be reached
+    server.stop();
+    makeStale(cache, "2023-12-04");
+    CHECK(fetchThroughCache(cache, server.host, "2023-12-04", true, locations));
+    CHECK(locations.size() == expected.size());
+    CHECK(!fetchThroughCache(cache, server.host, "2023-12-06", true, locations));
+    CHECK(locations.empty());
+
+    // concurrent writers to one path each get their own temporary file; every write succeeds,
+    // the result is one of them whole, and no temporary files are left behind
+    std::string target = dir.path + "/concurrent";
+    std::vector<std::thread> writers;
+    std::atomic<int> failures(0);
+    for (int t = 0; t < 8; t++) {
+        writers.emplace_back([&, t]() {
+            std::string contents(64 * 1024, (char)('a' + t));
+            for (int i = 0; i < 20; i++) {
+                if (!writeFileAtomically(target, contents.data(), contents.size())) { failures++; }
+            }
+        });
+    }
+    for (std::thread& t : writers) { t.join(); }
+    CHECK(failures == 0);
+    std::ifstream result(target, std::ios::binary);
+    std::string written((std::istreambuf_iterator<char>(result)), std::istreambuf_iterator<char>());
+    CHECK(written.size() == 64 * 1024);
+    CHECK(!written.empty() && written.find_first_not_of(written[0]) == std::string::npos);
+    size_t entries = 0;
+    DIR* d = opendir(dir.path.c_str());
+    while (struct dirent* entry = readdir(d)) {
+        if (strncmp(entry->d_name, "concurrent", 10) == 0) { entries++; }
+    }
+    closedir(d);
+    CHECK(entries == 1);
+
+    return checkResult();
+}
@@ -0,0 +1,101 @@
+// diff mode: diffLocations on hand-built schedules (nothing changed, added, removed, changed,
+// reordered), the exact changeLog lines, and GetScheduleDataDiff on the debug page, including a
+// failed fetch, which has to leave the snapshot alone
+
+#include "mizzou_internal.h"
+#include "check.h"
+#include "temp_dir.h"
+
+Location makeLocation(const std::string& name, const std::vector<TimeBlock>& hours) {
+    return Location(name, 0.0, 0.0, hours);
+}
+
+int main() {
+    int lunch = timeStrToInt("11:00 AM"), afternoon = timeStrToInt("2:00 PM");
+    std::vector<Location> before = {
+        makeLocation("Baja Grill", {TimeBlock("Lunch", lunch, afternoon)}),
+        makeLocation("Do Mundo's", {TimeBlock("Dinner", timeStrToInt("4:30 PM"), timeStrToInt("8:00 PM"))}),
+        makeLocation("Plaza 900", {TimeBlock("Breakfast", timeStrToInt("7:00 AM"), timeStrToInt("10:00 AM")),
+                                   TimeBlock("Lunch", lunch, afternoon)}),
+    };
+    std::vector<LocationChange> changes(1);
+
+    // the same schedule (another copy of it) gives nothing, and clears what was there
+    std::vector<Location> after = before;
+    diffLocations(before, after, changes);
+    CHECK(changes.empty());
+
+    // so does the same schedule in another order
+    std::reverse(after.begin(), after.end());
+    diffLocations(before, after, changes);
+    CHECK(changes.empty());
+
+    // a location added, one removed and one whose blocks changed, in name order
+    after = before;
+    after.erase(after.begin() + 1);
+    after[1].hours[0].start = timeStrToInt("7:30 AM");
+    after.push_back(makeLocation("Emporium Cafe", {TimeBlock("All Day", timeStrToInt("8:00 AM"), afternoon)}));
+    diffLocations(before, after, changes);
+    CHECK(changes.size() == 3);
+    if (changes.size() == 3) {
+        CHECK(changes[0].kind == LocationChange::REMOVED && changes[0].name == "Do Mundo's");
+        CHECK(changes[0].oldHours.size() == 1 && changes[0].newHours.empty());
+        CHECK(changes[1].kind == LocationChange::ADDED && changes[1].name == "Emporium Cafe");
+        CHECK(changes[1].oldHours.empty() && changes[1].newHours.size() == 1);
+        CHECK(changes[2].kind == LocationChange::CHANGED && changes[2].name == "Plaza 900");
+        CHECK(changes[2].oldHours.size() == 2 && changes[2].newHours.size() == 2);
+    }
+    CHECK(changeLog(changes) ==
+          "- Do Mundo's [Dinner 4:30 PM-8:00 PM]\n"
+          "+ Emporium Cafe [All Day 8:00 AM-2:00 PM]\n"
+          "~ Plaza 900 [Breakfast 7:00 AM-10:00 AM, Lunch 11:00 AM-2:00 PM] -> "
+          "[Breakfast 7:30 AM-10:00 AM, Lunch 11:00 AM-2:00 PM]\n");
+
+    // a block list that only grew, or only had a label changed, is a change too
+    after = before;
+    after[0].hours.push_back(TimeBlock("Dinner", timeStrToInt("5:00 PM"), timeStrToInt("7:00 PM")));
+    after[2].hours[1].label = "Brunch";
+    diffLocations(before, after, changes);
+    CHECK(changes.size() == 2);
+    CHECK(changeLog(changes) ==
+          "~ Baja Grill [Lunch 11:00 AM-2:00 PM] -> [Lunch 11:00 AM-2:00 PM, Dinner 5:00 PM-7:00 PM]\n"
+          "~ Plaza 900 [Breakfast 7:00 AM-10:00 AM, Lunch 11:00 AM-2:00 PM] -> "
+          "[Breakfast 7:00 AM-10:00 AM, Brunch 11:00 AM-2:00 PM]\n");
+    CHECK(changeLog(std::vector<LocationChange>()).empty());
+
+    // GetScheduleDataDiff on the debug page (locations.html in the working directory): the first
+    // fetch adds everything, the next finds nothing new
+    std::vector<Location> expected;
+    CHECK(fetchScheduleData("2023-12-04", true, expected));
+    CHECK(!expected.empty());
+    std::vector<Location> snapshot;
+    ClockSnapshot clock = ClockSnapshot::at(timeStrToInt("1:00 PM"));
+    CHECK(GetScheduleDataDiff("2023-12-04", true, snapshot, changes, clock));
+    CHECK(snapshot.size() == expected.size());
+    CHECK(changes.size() == expected.size());
+    for (const LocationChange& change : changes) { CHECK(change.kind == LocationChange::ADDED); }
+    CHECK(GetScheduleDataDiff("2023-12-04", true, snapshot, changes, clock));
+    CHECK(changes.empty());
+
+    // a failed fetch (no page in this directory) reports the failure, and neither the snapshot
+    // nor the last changes are touched, rather than reporting every location as removed
+    char cwd[4096];
+    CHECK(getcwd(cwd, sizeof(cwd)) != NULL);
+    TempDir empty;
+    CHECK(chdir(empty.path.c_str()) == 0);
+    changes.assign(1, LocationChange());
+    changes[0].name = "left alone";
+    CHECK(!GetScheduleDataDiff("2023-12-04", true, snapshot, changes, clock));
+    CHECK(chdir(cwd) == 0);
+    CHECK(snapshot.size() == expected.size());
+    for (size_t i = 0; i < snapshot.size() && i < expected.size(); i++) {
+        CHECK(snapshot[i].name == expected[i].name && sameHours(snapshot[i].hours, expected[i].hours));
+    }
+    CHECK(changes.size() == 1 && changes[0].name == "left alone");
+
+    // and the fetch after it is diffed against the last good one, so nothing comes back as added
+    CHECK(GetScheduleDataDiff("2023-12-04", true, snapshot, changes, clock));
+    CHECK(changes.empty());
+
+    return checkResult();
+}
@@ -0,0 +1,123 @@
+// GetScheduleRange against a local httplib::Server that serves locations.html with a fixed
+// delay per request, so the concurrency bound and the overlap of requests can be checked
+
+#include "mizzou_internal.h"
+#include "check.h"
+#include "temp_dir.h"
+
+#include <chrono>
+
+#define LATENCY_MS 100
+
+int main() {
+    std::ifstream file("locations.html");
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(!html.empty());
+
+    std::vector<Location> expected;
+    CHECK(parseScheduleHtml(html, expected));
+
+    std::atomic<int> inFlight(0), maxInFlight(0);
+    httplib::Server server;
+    server.Get("/locations/", [&](const httplib::Request& req, httplib::Response& res) {
+        int n = ++inFlight;
+        int seen = maxInFlight;
+        while (n > seen && !maxInFlight.compare_exchange_weak(seen, n)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(LATENCY_MS));
+        --inFlight;
+        // one date fails, to check that it doesn't take the others down with it
+        if (req.get_param_value("hoursForDate") == "2024-01-01") {
+            res.status = 500;
+            return;
+        }
+        // like the real site, the page differs from date to date outside the tables
+        res.set_content("<!-- " + req.get_param_value("hoursForDate") + " -->" + html, "text/html");
+    });
+    server.set_keep_alive_max_count(100);
+    server.set_keep_alive_timeout(1); // so stop() doesn't wait long on the pooled connections
+    int port = server.bind_to_any_port("127.0.0.1");
+    CHECK(port > 0);
+    std::thread listener([&]() { server.listen_after_bind(); });
+    server.wait_until_ready();
+    std::string host = "http://127.0.0.1:" + std::to_string(port);
+
+    // a cache of its own, so nothing is left over from an earlier run
+    TempDir cacheDir;
+    ScheduleCache cache(cacheDir.path);
+
+    const int concurrency = 3;
+    size_t memoHits = parseCache().hits, memoMisses = parseCache().misses;
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<DaySchedule> days = GetScheduleRange("2023-12-28", "2024-01-03", concurrency, host,
+                                                     ClockSnapshot::at(timeStrToInt("1:00 PM")), cache);
+    long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    CHECK(days.size() == 7);
+    for (const DaySchedule& day : days) {
+        if (day.date == "2024-01-01") {
+            CHECK(!day.ok);
+            CHECK(day.locations.empty());
+            continue;
+        }
+        CHECK(day.ok);
+        CHECK(day.locations.size() == expected.size());
+        for (size_t i = 0; i < day.locations.size() && i < expected.size(); i++) {
+            CHECK(day.locations[i].name == expected[i].name);
+            CHECK(day.locations[i].hours.size() == expected[i].hours.size());
+        }
+    }
+    CHECK(days.front().date == "2023-12-28" && days.back().date == "2024-01-03");
+
+    // every page had the same tables, so only the first few workers (racing each other) parsed
+    memoHits = parseCache().hits - memoHits;
+    memoMisses = parseCache().misses - memoMisses;
+    CHECK(memoHits + memoMisses == 6);
+    CHECK(memoMisses >= 1 && memoMisses <= (size_t)concurrency);
+
+    // at most `concurrency` requests at once, but they did overlap: one at a time would take
+    // at least 7 * LATENCY_MS
+    CHECK(maxInFlight <= concurrency);
+    CHECK(maxInFlight > 1);
+    CHECK(ms >= 3 * LATENCY_MS);
+    CHECK(ms < 7 * LATENCY_MS);
+    printf("7 dates with %d ms latency, concurrency %d: %ld ms, at most %d in flight\n",
+           LATENCY_MS, concurrency, ms, (int)maxInFlight);
+
+    // the workers' connections went back to the pool, so a second range (through an empty cache,
+    // so it really fetches) reuses them, except the one that gave up on the 500 part way through
+    TempDir otherCacheDir;
+    ScheduleCache otherCache(otherCacheDir.path);
+    ClientPoolStats before = clientPoolStats();
+    days = GetScheduleRange("2023-12-28", "2023-12-30", concurrency, host, ClockSnapshot::now(), otherCache);
+    ClientPoolStats after = clientPoolStats();
+    CHECK(after.requests - before.requests == 3);
+    CHECK(after.connections - before.connections <= 1);
+    CHECK(after.handshakesAvoided - before.handshakesAvoided >= 2);
+
+    // the pages went into the cache, so asking again doesn't touch the server
+    maxInFlight = 0;
+    days = GetScheduleRange("2023-12-28", "2023-12-31", concurrency, host, ClockSnapshot::now(), cache);
+    CHECK(maxInFlight == 0);
+    CHECK(cache.stats.hits == 4);
+    for (const DaySchedule& day : days) { CHECK(day.ok && day.locations.size() == expected.size()); }
+
+    CHECK(GetScheduleRange("2024-01-03", "2023-12-28", concurrency, host, ClockSnapshot::now(), cache).empty());
+
+    server.stop();
+    listener.join();
+
+    // fetches that never reach the server don't count as handshakes avoided, though they made no
+    // new connection either (an empty cache, so they do try)
+    TempDir emptyCacheDir;
+    ScheduleCache emptyCache(emptyCacheDir.path);
+    before = clientPoolStats();
+    days = GetScheduleRange("2023-12-28", "2023-12-29", concurrency, host, ClockSnapshot::now(), emptyCache);
+    after = clientPoolStats();
+    CHECK(days.size() == 2);
+    for (const DaySchedule& day : days) { CHECK(!day.ok); }
+    CHECK(after.requests - before.requests == 2);
+    CHECK(after.connections == before.connections);
+    CHECK(after.handshakesAvoided == before.handshakesAvoided);
+    return checkResult();
+}
@@ -0,0 +1,104 @@
+// serving mode (ScheduleServer) against a local PageServer: 503 until the first refresh, the
+// /locations and /open bodies, the last good snapshot served while a refresh is still downloading
+// and after one fails, and a new page served once a refresh gets it
+
+#include "mizzou_internal.h"
+#include "check.h"
+#include "temp_dir.h"
+#include "page_server.h"
+
+#define DATE "2023-12-04"
+
+// what /locations and /open should say about `locations` at `clock`
+void expectedBodies(std::vector<Location> locations, const ClockSnapshot& clock, std::string& all,
+                    std::string& open) {
+    applyHardCodedCoordinates(locations);
+    evaluateOpenStatus(locations, clock);
+    all = serializeLocations(locations);
+    open.clear();
+    for (const Location& l : locations) {
+        if (l.open) { open += l.name + "\n"; }
+    }
+}
+
+// checks that the server answers both requests from `locations`; the bodies are worked out
+// before and after the requests, either of which they can match if a minute ticks over between
+bool serves(httplib::Client& client, const std::vector<Location>& locations) {
+    std::string all, open, allAfter, openAfter;
+    expectedBodies(locations, ClockSnapshot::now(), all, open);
+    auto a = client.Get("/locations");
+    auto o = client.Get("/open");
+    expectedBodies(locations, ClockSnapshot::now(), allAfter, openAfter);
+    return a && a->status == 200 && a->has_header("Age") && (a->body == all || a->body == allAfter)
+           && o && o->status == 200 && o->has_header("Age") && (o->body == open || o->body == openAfter);
+}
+
+int main() {
+    std::ifstream file("locations.html");
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(!html.empty());
+    std::vector<Location> expected;
+    CHECK(parseScheduleHtml(html, expected));
+    CHECK(!expected.empty());
+
+    // the same page with the first location renamed, so it's clear which one is being served
+    std::string renamedHtml = html;
+    std::string link = ">" + expected[0].name + "</a>";
+    size_t pos = renamedHtml.find(link);
+    CHECK(pos != std::string::npos);
+    if (pos != std::string::npos) { renamedHtml.replace(pos, link.size(), ">Renamed Grill</a>"); }
+    std::vector<Location> renamed;
+    CHECK(parseScheduleHtml(renamedHtml, renamed));
+    CHECK(renamed.size() == expected.size() && renamed[0].name == "Renamed Grill");
+
+    TempDir cacheDir;
+    ScheduleCache cache(cacheDir.path);
+    PageServer pages(html);
+
+    // the background refresher isn't started; refresh() is called by hand instead
+    ScheduleServer scheduleServer(DATE, false, 3600, pages.host, cache);
+    int port = scheduleServer.server.bind_to_any_port("127.0.0.1");
+    CHECK(port > 0);
+    std::thread listener([&]() { scheduleServer.server.listen_after_bind(); });
+    scheduleServer.server.wait_until_ready();
+    httplib::Client client("127.0.0.1", port);
+
+    // nothing to serve before the first fetch
+    auto res = client.Get("/locations");
+    CHECK(res && res->status == 503);
+    res = client.Get("/open");
+    CHECK(res && res->status == 503);
+
+    CHECK(scheduleServer.refresh());
+    CHECK(pages.sent == 1);
+    CHECK(serves(client, expected));
+
+    // while a refresh waits on a slow site, requests are answered right away from the last
+    // snapshot; the new page is served once the refresh finishes
+    pages.setPage(renamedHtml);
+    pages.delayMs = 500;
+    int refreshed = 0;
+    std::thread refresher([&]() { refreshed = scheduleServer.refresh(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto begin = std::chrono::steady_clock::now();
+    CHECK(serves(client, expected));
+    CHECK(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(300));
+    refresher.join();
+    CHECK(refreshed);
+    CHECK(pages.sent == 2);
+    CHECK(serves(client, renamed));
+
+    // with the site down, a refresh falls back to the cached page, which is still the same
+    pages.stop();
+    CHECK(scheduleServer.refresh());
+    CHECK(serves(client, renamed));
+
+    // and without that to fall back on, the refresh fails and the last snapshot is kept
+    CHECK(unlink(cache.metaPath(DATE).c_str()) == 0);
+    CHECK(!scheduleServer.refresh());
+    CHECK(serves(client, renamed));
+
+    scheduleServer.stop();
+    listener.join();
+    return checkResult();
+}
@@ -0,0 +1,147 @@
+// ScheduleStore: a store written by writeScheduleStore opens and answers queries, and a store
+// with any section or id pointing outside the file is refused by open() instead of being read
+// out of bounds later
+
+#include "mizzou_internal.h"
+#include "check.h"
+#include "temp_dir.h"
+
+std::string readAll(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeAll(const std::string& path, const std::string& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+ScheduleStoreHeader headerOf(const std::string& bytes) {
+    ScheduleStoreHeader h;
+    memcpy(&h, bytes.data(), sizeof(h));
+    return h;
+}
+
+void setHeader(std::string& bytes, const ScheduleStoreHeader& h) {
+    memcpy(&bytes[0], &h, sizeof(h));
+}
+
+void setU32(std::string& bytes, uint64_t off, uint32_t v) {
+    memcpy(&bytes[off], &v, sizeof(v));
+}
+
+// true if `bytes`, written out as a store, is refused by open()
+bool refused(const std::string& path, const std::string& bytes) {
+    writeAll(path, bytes);
+    ScheduleStore store;
+    return store.open(path) == 0 && store.header == NULL;
+}
+
+int main() {
+    TempDir dir;
+    std::string path = dir.path + "/schedule.mzss";
+    std::string corrupt = dir.path + "/corrupt.mzss";
+
+    std::vector<Location> page = GetScheduleData("2023-12-04", true);
+    CHECK(page.size() > 2);
+    std::vector<DaySchedule> days(3);
+    const char* dates[] = {"2023-12-05", "2023-12-04", "2023-12-06"};
+    for (int i = 0; i < 3; i++) {
+        days[i].date = dates[i];
+        days[i].ok = true;
+        days[i].locations = page;
+    }
+    days[2].locations.pop_back(); // one location closed on the last day
+    CHECK(writeScheduleStore(path, days));
+
+    {
+        ScheduleStore store;
+        CHECK(store.open(path));
+        CHECK(store.header->dateCount == 3);
+        CHECK(store.header->locationCount == page.size());
+        CHECK(store.findDate("2023-12-04") == 0 && store.findDate("2023-12-06") == 2);
+        CHECK(store.findDate("2023-12-07") == -1);
+        CHECK(store.locationName(0) == page[0].name);
+        CHECK(store.label(0) == page[0].hours[0].label);
+
+        std::vector<uint64_t> minutes;
+        store.totalOpenMinutes(minutes);
+        const TimeBlock& first = page[0].hours[0];
+        CHECK(minutes.size() == page.size());
+        CHECK(minutes[0] >= 3 * (uint64_t)(first.end - first.start + 1));
+        CHECK(store.datesOpenAt(0, first.start) == 3);
+        uint32_t last = (uint32_t)page.size() - 1;
+        if (!page[last].hours.empty()) { CHECK(store.datesOpenAt(last, page[last].hours[0].start) == 2); }
+    }
+
+    const std::string good = readAll(path);
+    const ScheduleStoreHeader h = headerOf(good);
+    std::string bytes;
+    ScheduleStoreHeader bad;
+
+    // the unmodified copy still opens
+    CHECK(!refused(corrupt, good));
+
+    // truncated, with and without the size in the header agreeing
+    CHECK(refused(corrupt, good.substr(0, good.size() - 1)));
+    bytes = good.substr(0, h.blockEndsOff + 2);
+    bad = h;
+    bad.fileSize = bytes.size();
+    setHeader(bytes, bad);
+    CHECK(refused(corrupt, bytes));
+
+    // sections past the end, overflowing, or misaligned
+    bytes = good;
+    bad = h;
+    bad.blockLabelsOff = good.size() - 4;
+    setHeader(bytes, bad);
+    CHECK(refused(corrupt, bytes));
+
+    bad = h;
+    bad.labelOffsetsOff = 0xfffffffffffff000ULL;
+    setHeader(bytes, bad);
+    CHECK(refused(corrupt, bytes));
+
+    bad = h;
+    bad.latitudesOff += 4;
+    setHeader(bytes, bad);
+    CHECK(refused(corrupt, bytes));
+
+    bad = h;
+    bad.blockCount = 0x40000000;
+    setHeader(bytes, bad);
+    CHECK(refused(corrupt, bytes));
+
+    // ids outside their dictionaries
+    bytes = good;
+    setU32(bytes, h.blockLocationsOff, h.locationCount);
+    CHECK(refused(corrupt, bytes));
+
+    bytes = good;
+    setU32(bytes, h.blockLabelsOff + 4 * (h.blockCount - 1), h.labelCount);
+    CHECK(refused(corrupt, bytes));
+
+    // string offsets running past their bytes, or backwards
+    bytes = good;
+    setU32(bytes, h.nameOffsetsOff + 4 * h.locationCount, (uint32_t)good.size());
+    CHECK(refused(corrupt, bytes));
+
+    bytes = good;
+    setU32(bytes, h.labelOffsetsOff + 4, 0xffffff00);
+    CHECK(refused(corrupt, bytes));
+
+    // a date's blocks running past the block columns, or dates out of order
+    bytes = good;
+    setU32(bytes, h.dateBlocksOff + 4 * h.dateCount, h.blockCount + 1);
+    CHECK(refused(corrupt, bytes));
+
+    bytes = good;
+    setU32(bytes, h.datesOff, 20991231);
+    CHECK(refused(corrupt, bytes));
+
+    // not a store at all
+    CHECK(refused(corrupt, std::string(sizeof(ScheduleStoreHeader) - 1, '\0')));
+    CHECK(refused(corrupt, std::string(4096, 'x')));
+
+    return checkResult();
+}
@@ -0,0 +1,71 @@
+// the streaming (SAX) parse against the DOM parse: ScheduleStreamParser fed locations.html in
+// chunks of 1 byte, a few odd sizes, random sizes and all at once has to find the same locations,
+// hours and 'open' flags as parseScheduleHtml; so does StreamScheduleData in debug mode
+
+#include "mizzou_internal.h"
+#include "check.h"
+
+#include <random>
+
+bool sameLocations(const std::vector<Location>& a, const std::vector<Location>& b) {
+    if (a.size() != b.size()) { return false; }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].name != b[i].name || a[i].open != b[i].open || !sameHours(a[i].hours, b[i].hours)) { return false; }
+    }
+    return true;
+}
+
+// parses html with a ScheduleStreamParser, fed `chunk(i)` bytes at a time for the i-th chunk
+template <typename ChunkSize>
+std::vector<Location> streamed(const std::string& html, const ClockSnapshot& clock, ChunkSize chunk) {
+    std::vector<Location> locations;
+    ScheduleStreamParser parser(locations, clock);
+    for (size_t pos = 0, i = 0; pos < html.size(); i++) {
+        size_t len = std::min(chunk(i), html.size() - pos);
+        CHECK(parser.feed(html.data() + pos, len));
+        pos += len;
+    }
+    CHECK(parser.finish());
+    return locations;
+}
+
+int main() {
+    std::ifstream file("locations.html");
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(!html.empty());
+
+    // a time when some locations are open and some aren't, so the flags are compared too
+    ClockSnapshot clock = ClockSnapshot::at(timeStrToInt("1:00 PM"));
+    std::vector<Location> expected;
+    CHECK(parseScheduleHtml(html, expected));
+    evaluateOpenStatus(expected, clock);
+    CHECK(!expected.empty());
+    size_t open = 0;
+    for (const Location& l : expected) { open += l.open; }
+    CHECK(open > 0 && open < expected.size());
+
+    size_t sizes[] = {1, 2, 7, 13, 4096, 1 << 20};
+    for (size_t size : sizes) {
+        std::vector<Location> locations = streamed(html, clock, [&](size_t) { return size; });
+        if (!sameLocations(expected, locations)) {
+            fprintf(stderr, "%zu byte chunks parsed differently\n", size);
+            CHECK(false);
+        }
+    }
+
+    // chunk boundaries anywhere: in tags, entities, names and hours
+    std::mt19937 rng(5);
+    for (int round = 0; round < 20; round++) {
+        std::vector<Location> locations = streamed(html, clock, [&](size_t) { return (size_t)(1 + rng() % 97); });
+        if (!sameLocations(expected, locations)) {
+            fprintf(stderr, "random chunks (round %d) parsed differently\n", round);
+            CHECK(false);
+        }
+    }
+
+    // and through the debug path of StreamScheduleData (4 KiB reads of the same file)
+    CHECK(sameLocations(expected, StreamScheduleData("2023-12-04", true, clock)));
+    CHECK(sameLocations(GetScheduleData("2023-12-04", true, clock), StreamScheduleData("2023-12-04", true, clock)));
+
+    return checkResult();
+}